@@ -5,34 +5,33 @@
 #include <chrono>
 #include "AndersonTauLeap.h"
 #include "utilities/Utility.h"
+#include "utilities/Profiler.h"
 #include "utilities/types.h"
 
 
 void Anderson::AndersonTauLeap(double &tLastNetworkUpdate, double tEnd, ContactNetwork & contNetwork,
                      std::mt19937_64 &generator)
 {
-    size_t M = 2; //number of reactions, size of propensity vector
-
-    std::vector<double> T(M, 0);
-    std::vector<size_t> C(M, 0);
-
-    std::vector<std::vector<std::pair<double, size_t>>> S;
-    S.reserve(1e6 + 1);
-    S.push_back({{0.0, 0}});
-    S.push_back({{0.0, 0}});
+    Workspace workspace;
+    AndersonTauLeap(tLastNetworkUpdate, tEnd, contNetwork, generator, workspace);
+}
 
-    std::vector<double> propensities(M, 0);
-    std::vector<std::pair<double, Edge>> propDel = contNetwork.getEdgeDeletionRateSum();
-    std::vector<std::pair<double, Edge>> propAdd = contNetwork.getEdgeAdditionRateSum();
+void Anderson::AndersonTauLeap(double &tLastNetworkUpdate, double tEnd, ContactNetwork & contNetwork,
+                     std::mt19937_64 &generator, Workspace &workspace)
+{
+    Profiler::Timer timer(Profiler::TauLeap);
+    size_t M = 2; //number of reactions, size of propensity vector
 
-    propensities.at(0) = propDel.back().first;
-    propensities.at(1) = propAdd.back().first;
+    startMemory(M, workspace.T, workspace.C, workspace.S, workspace.row);
 
-    std::vector<size_t> row(M, 0);
+    std::vector<double> &propensities = workspace.propensities;
+    std::vector<size_t> &X = workspace.X;
+    propensities.assign(M, 0);
+    X.assign(M, 0);
+    getPropensities(contNetwork, propensities, X, workspace.propAdd, workspace.propDel);
 
     double t = tLastNetworkUpdate;
 
-    std::vector<size_t> X = {propDel.size() - 1, propAdd.size() - 1};
     double tau = getTau(propensities, X);
     while (t < tEnd)
     {
@@ -45,22 +44,18 @@ void Anderson::AndersonTauLeap(double &tLastNetworkUpdate, double tEnd, ContactN
 
         if (tau < 10.0 / (propensities.at(0) + propensities.at(1)))
         {
-            executeSSA(100, M, tEnd, contNetwork, t, tLastNetworkUpdate, generator, T, C, S);
-            propDel = contNetwork.getEdgeDeletionRateSum();
-            propAdd = contNetwork.getEdgeAdditionRateSum();
-
-            propensities.at(0) = propDel.back().first;
-            propensities.at(1) = propAdd.back().first;
-            X = {propDel.size() - 1, propAdd.size() - 1};
+            executeSSA(100, M, tEnd, contNetwork, t, tLastNetworkUpdate, generator, workspace);
+            getPropensities(contNetwork, propensities, X, workspace.propAdd, workspace.propDel);
             tau = getTau(propensities, X);
         }
 
         else
         {
-            std::vector<size_t> change = getChange(M, S, T, C, propensities, row, tau, generator);
+            std::vector<size_t> &change = workspace.change;
+            getChange(M, workspace.S, workspace.T, workspace.C, propensities, workspace.row, tau, generator, change);
 
-            bool pass = change.at(0) <= std::max(epsilon * (propDel.size() - 1), 1.0) &&
-                        change.at(1) <= std::max(epsilon * (propAdd.size() - 1), 1.0);
+            bool pass = change.at(0) <= std::max(epsilon * X.at(0), 1.0) &&
+                        change.at(1) <= std::max(epsilon * X.at(1), 1.0);
 
             if (pass)
             {
@@ -69,35 +64,48 @@ void Anderson::AndersonTauLeap(double &tLastNetworkUpdate, double tEnd, ContactN
                     t = tEnd;
                     break;
                 }
-                acceptLeap(t, tLastNetworkUpdate, tau, M, contNetwork,
-                        S, T, C, row, propensities, change,
-                        propAdd,propDel,generator);
+                Profiler::count(Profiler::LeapsAccepted);
+                acceptLeap(t, tLastNetworkUpdate, tau, M, contNetwork, workspace, generator);
             }
             else
             {
-                rejectLeap(M,  tau, S, T, C, propensities, row, change);
+                Profiler::count(Profiler::LeapsRejected);
+                rejectLeap(M,  tau, workspace.S, workspace.T, workspace.C, propensities, workspace.row, change);
             }
         }
     }
 }
 
+void Anderson::startMemory(size_t M, std::vector<double> &T, std::vector<size_t> &C,
+                           std::vector<std::vector<std::pair<double, size_t>>> &S, std::vector<size_t> &row)
+{
+    T.assign(M, 0);
+    C.assign(M, 0);
+    row.assign(M, 0);
+    S.resize(M);
+    for (std::vector<std::pair<double, size_t>> &Sk: S)
+    {
+        Sk.clear();
+        Sk.emplace_back(0.0, 0);
+    }
+}
+
 void Anderson::executeSSA(size_t n, size_t M, double tEnd, ContactNetwork & contNetwork, double &t,
-                double &tLastNetworkUpdate, std::mt19937_64 &generator,
-                std::vector<double> &T, std::vector<size_t> &C,
-                std::vector<std::vector<std::pair<double, size_t>>> &S)
+                double &tLastNetworkUpdate, std::mt19937_64 &generator, Workspace &workspace)
 
 {
-    std::vector<double> propensities(M, 0);
-    std::vector<std::pair<double, Edge>> propDel;
-    std::vector<std::pair<double, Edge>> propAdd;
+    TraceRecorder::Span span("ssa_fallback");
+    std::vector<double> &propensities = workspace.propensities;
+    std::vector<size_t> &X = workspace.X;
+    std::vector<double> &T = workspace.T;
+    std::vector<size_t> &C = workspace.C;
+    std::vector<std::vector<std::pair<double, size_t>>> &S = workspace.S;
+    std::vector<std::pair<double, Edge>> &propAdd = workspace.propAdd;
+    std::vector<std::pair<double, Edge>> &propDel = workspace.propDel;
 
     for (size_t ind = 0; ind < n; ind++)
     {
-        propDel = contNetwork.getEdgeDeletionRateSum();
-        propAdd = contNetwork.getEdgeAdditionRateSum();
-
-        propensities.at(0) = propDel.back().first;
-        propensities.at(1) = propAdd.back().first;
+        getPropensities(contNetwork, propensities, X, propAdd, propDel);
 
         double propensitiesSum = propensities.at(0) + propensities.at(1);
 
@@ -121,10 +129,18 @@ void Anderson::executeSSA(size_t n, size_t M, double tEnd, ContactNetwork & cont
 
         t += proposedTime;
         tLastNetworkUpdate = t; //used to update netw. Upd.Time
+        Profiler::count(Profiler::SSAFallbackSteps);
+        Profiler::count(Profiler::ContactReactions);
 
         double rbound =  propensitiesSum * sampleRandUni(generator);
         //deletion
-        if (propensities.at(0) >= rbound)
+        if (propensities.at(0) >= rbound && contNetwork.hasHomogeneousContacts())
+        {
+            Edge e = contNetwork.sampleEdgeDeletion(generator);
+            contNetwork.removeEdge(e);
+            C.at(0)++;
+        }
+        else if (propensities.at(0) >= rbound)
         {
             auto edgeIterator = std::lower_bound(propDel.begin(), propDel.end(), rbound, lambdaLess);
 
@@ -136,6 +152,12 @@ void Anderson::executeSSA(size_t n, size_t M, double tEnd, ContactNetwork & cont
             contNetwork.removeEdge(edgeIterator->second);
             C.at(0)++;
         }
+        else if (contNetwork.hasHomogeneousContacts())
+        {
+            Edge e = contNetwork.sampleEdgeAddition(generator);
+            contNetwork.addEdge(e);
+            C.at(1)++;
+        }
         else
         {
             auto edgeIterator = std::lower_bound(propAdd.begin(), propAdd.end(), rbound - propensities.at(0), lambdaLess);
@@ -162,6 +184,27 @@ void Anderson::executeSSA(size_t n, size_t M, double tEnd, ContactNetwork & cont
         }
     }
 }
+void Anderson::getPropensities(ContactNetwork & contNetwork, std::vector<double> &propensities, std::vector<size_t> &X,
+                               std::vector<std::pair<double, Edge>> &propAdd,
+                               std::vector<std::pair<double, Edge>> &propDel)
+{
+    if (contNetwork.hasHomogeneousContacts())
+    {
+        propDel.clear();
+        propAdd.clear();
+        propensities.at(0) = contNetwork.getEdgeDeletionPropensity();
+        propensities.at(1) = contNetwork.getEdgeAdditionPropensity();
+        X = {contNetwork.countDeletableEdges(), contNetwork.countAddableEdges()};
+        return;
+    }
+    contNetwork.getEdgeDeletionRateSum(propDel);
+    contNetwork.getEdgeAdditionRateSum(propAdd);
+
+    propensities.at(0) = propDel.back().first;
+    propensities.at(1) = propAdd.back().first;
+    X = {propDel.size() - 1, propAdd.size() - 1};
+}
+
 double Anderson::getTau(const std::vector<double> &props, const std::vector<size_t> &X)
 {
     double gi = 1.0;
@@ -182,21 +225,35 @@ double Anderson::getTau(const std::vector<double> &props, const std::vector<size
 }
 
 
-void Anderson::updateNetwork(std::vector<size_t> k, std::mt19937_64 &generator,
+void Anderson::updateNetwork(const std::vector<size_t> &k, std::vector<size_t> &order, std::mt19937_64 &generator,
                    std::vector<std::pair<double, Edge>> &propAdd,
                    std::vector<std::pair<double, Edge>> &propDel,
                    ContactNetwork & contNetwork)
 {
-    std::vector<size_t> order;
+    order.clear();
     for (size_t ind = 0; ind < k.size(); ind++)
     {
         order.insert(order.end(), k.at(ind), ind);
     }
     std::shuffle(order.begin(), order.end(), generator);
+    Profiler::count(Profiler::ContactReactions, order.size());
 
     for (auto i : order)
     {
-        if (i == 0)
+        if (contNetwork.hasHomogeneousContacts())
+        {
+            // rates do not change by adding/removing edges, the edge is sampled from the current network
+            Edge e = i == 0 ? contNetwork.sampleEdgeDeletion(generator) : contNetwork.sampleEdgeAddition(generator);
+            if (i == 0)
+            {
+                contNetwork.removeEdge(e);
+            }
+            else
+            {
+                contNetwork.addEdge(e);
+            }
+        }
+        else if (i == 0)
         {
             double rbound = propDel.back().first * sampleRandUni(generator);
             auto edgeIterator = std::lower_bound(propDel.begin(), propDel.end(), rbound, lambdaLess);
@@ -207,10 +264,11 @@ void Anderson::updateNetwork(std::vector<size_t> k, std::mt19937_64 &generator,
                 throw std::domain_error(msg);
             }
 
-            std::pair<int, int> b = contNetwork.removeEdge(edgeIterator->second);
+            // the removed edge is the same edge of the complement, no lookup by its nodes
+            Edge e = edgeIterator->second;
+            contNetwork.removeEdge(e);
             propDel.erase(edgeIterator);
 
-            Edge e = contNetwork.getComplementEdge(b.first, b.second);
             propAdd.emplace_back(propAdd.back().first + contNetwork.getEdgeAdditionRate(e), e);
 
         }
@@ -225,10 +283,10 @@ void Anderson::updateNetwork(std::vector<size_t> k, std::mt19937_64 &generator,
                 throw std::domain_error(msg);
             }
 
-            std::pair<int, int> b = contNetwork.addEdge(edgeIterator->second);
+            Edge e = edgeIterator->second;
+            contNetwork.addEdge(e);
             propAdd.erase(edgeIterator);
 
-            Edge e = contNetwork.getEdge(b.first, b.second);
             propDel.emplace_back(propDel.back().first + contNetwork.getEdgeDeletionRate(e), e);
         }
     }
@@ -257,16 +315,16 @@ double Anderson::updateTau(double tau, size_t numOfEdgesExist, size_t numOfEdges
     return result;
 }
 
-std::vector<size_t> Anderson::getChange(size_t M, const std::vector<std::vector<std::pair<double, size_t>>> &S,
+void Anderson::getChange(size_t M, const std::vector<std::vector<std::pair<double, size_t>>> &S,
                          const std::vector<double> &T, const std::vector<size_t> &C,
                          const std::vector<double> &propensities, std::vector<size_t> &row,
-                         double tau, std::mt19937_64 &generator)
+                         double tau, std::mt19937_64 &generator, std::vector<size_t> &change)
 {
-    std::vector<size_t> change(M, 0);
+    change.assign(M, 0);
 
     for (size_t i = 0; i < M; i ++)
     {
-        std::vector<std::pair<double, size_t>> Sk = S.at(i);
+        const std::vector<std::pair<double, size_t>> &Sk = S.at(i);
         size_t B = Sk.size() - 1;
         if (propensities.at(i) * tau + T.at(i) >= Sk.at(B).first)
         {
@@ -294,19 +352,19 @@ std::vector<size_t> Anderson::getChange(size_t M, const std::vector<std::vector<
         }
     }
 
-    return change;
 }
 
 void Anderson::acceptLeap(double &t, double &tLastNetworkUpdate, double &tau, size_t M,
-                ContactNetwork & contNetwork,
-                std::vector<std::vector<std::pair<double, size_t>>> &S,
-                std::vector<double> &T, std::vector<size_t> &C,
-                std::vector<size_t> &row, std::vector<double> &propensities,
-                const std::vector<size_t> &change,
-                std::vector<std::pair<double, Edge>> &propAdd,
-                std::vector<std::pair<double, Edge>> &propDel,
-                std::mt19937_64 &generator)
+                ContactNetwork & contNetwork, Workspace &workspace, std::mt19937_64 &generator)
 {
+    TraceRecorder::Span span("leap_accept");
+    std::vector<std::vector<std::pair<double, size_t>>> &S = workspace.S;
+    std::vector<double> &T = workspace.T;
+    std::vector<size_t> &C = workspace.C;
+    std::vector<size_t> &row = workspace.row;
+    std::vector<double> &propensities = workspace.propensities;
+    std::vector<size_t> &X = workspace.X;
+    const std::vector<size_t> &change = workspace.change;
     for (size_t i = 0; i < M; i ++)
     {
         T.at(i) += propensities.at(i) * tau;
@@ -318,16 +376,12 @@ void Anderson::acceptLeap(double &t, double &tLastNetworkUpdate, double &tau, si
     }
 
     t+= tau;
-    tau = updateTau(tau, propDel.size() - 1, propAdd.size() - 1, change);
+    tau = updateTau(tau, X.at(0), X.at(1), change);
 
 
-    updateNetwork(change, generator, propAdd, propDel,contNetwork);
+    updateNetwork(change, workspace.order, generator, workspace.propAdd, workspace.propDel, contNetwork);
     tLastNetworkUpdate = t;
-    propDel = contNetwork.getEdgeDeletionRateSum();
-    propAdd = contNetwork.getEdgeAdditionRateSum();
-
-    propensities.at(0) = propDel.back().first;
-    propensities.at(1) = propAdd.back().first;
+    getPropensities(contNetwork, propensities, X, workspace.propAdd, workspace.propDel);
 }
 
 void Anderson::rejectLeap(size_t M,  double &tau, std::vector<std::vector<std::pair<double, size_t>>> &S,
@@ -335,6 +389,7 @@ void Anderson::rejectLeap(size_t M,  double &tau, std::vector<std::vector<std::p
                 const std::vector<double> &propensities, std::vector<size_t> &row,
                 const std::vector<size_t> &change)
 {
+    TraceRecorder::Span span("leap_reject");
     for (size_t i = 0; i < M; i ++)
     {
         std::pair<double, size_t> toInsert(propensities.at(i) * tau + T.at(i), C.at(i) + change.at(i));
@@ -11,40 +11,73 @@
 
 class Anderson{
 public:
+/*
+ * buffers kept by the caller between calls of AndersonTauLeap, so that they are not allocated anew for every interval:
+ * cumulative sums of contact rates and the memory of the leaps of the interval (internal times T, numbers of
+ * reactions C, draws S of rejected leaps, @see getChange)
+ */
+struct Workspace
+{
+    std::vector<std::pair<double, Edge>> propAdd;
+    std::vector<std::pair<double, Edge>> propDel;
+
+    std::vector<double> T;
+    std::vector<size_t> C;
+    std::vector<std::vector<std::pair<double, size_t>>> S;
+    std::vector<double> propensities;
+    std::vector<size_t> X;
+    std::vector<size_t> row;
+    std::vector<size_t> change;
+    std::vector<size_t> order; // reactions of a leap in random order
+};
+
+static void AndersonTauLeap(double &tLastNetworkUpdate, double tEnd, ContactNetwork & contNetwork, std::mt19937_64 &generator,
+                            Workspace &workspace);
 static void AndersonTauLeap(double &tLastNetworkUpdate, double tEnd, ContactNetwork & contNetwork, std::mt19937_64 &generator);
 
 private:
+friend class TauLeap; // leaps of all channels reuse the memory of rejected leaps and the update of contacts
 
 Anderson(){};
 
-static void updateNetwork(std::vector<size_t> k, std::mt19937_64 &generator,
+/*
+ * propensities of deletions and additions of edges and numbers X of edges / complement edges with rate > 0.
+ * Cumulative sums propDel, propAdd are built only if contact rates are not homogeneous
+ * (@see ContactNetwork::hasHomogeneousContacts), otherwise they are empty and edges are sampled by the network.
+ */
+static void getPropensities(ContactNetwork & contNetwork, std::vector<double> &propensities, std::vector<size_t> &X,
+                            std::vector<std::pair<double, Edge>> &propAdd,
+                            std::vector<std::pair<double, Edge>> &propDel);
+
+/*
+ * resets the memory of the leaps of M channels, @see Workspace
+ */
+static void startMemory(size_t M, std::vector<double> &T, std::vector<size_t> &C,
+                        std::vector<std::vector<std::pair<double, size_t>>> &S, std::vector<size_t> &row);
+
+static void updateNetwork(const std::vector<size_t> &k, std::vector<size_t> &order, std::mt19937_64 &generator,
                    std::vector<std::pair<double, Edge>> &propAdd,
                    std::vector<std::pair<double, Edge>> &propDel,
                    ContactNetwork & contNetwork);
 
 
 static void executeSSA(size_t n, size_t M, double tEnd, ContactNetwork & contNetwork, double &t,
-                double &tLastNetworkUpdate, std::mt19937_64 &generator,
-                std::vector<double> &T, std::vector<size_t> &C,
-                std::vector<std::vector<std::pair<double, size_t>>> &S);
+                double &tLastNetworkUpdate, std::mt19937_64 &generator, Workspace &workspace);
 
 static double getTau(const std::vector<double> &props, const std::vector<size_t> &X);
 static double updateTau(double tau, size_t numOfEdgesExist, size_t numOfEdgesComplement, const std::vector<size_t>& NN);
 
-static std::vector<size_t> getChange(size_t M, const std::vector<std::vector<std::pair<double, size_t>>> &S,
-                                            const std::vector<double> &T, const std::vector<size_t> &C,
-                                            const std::vector<double> &propensities, std::vector<size_t> &row,
-                                            double tau, std::mt19937_64 &generator);
+/*
+ * numbers of reactions of the channels during tau, consistent with the draws of rejected leaps
+ * @param change out: numbers of reactions
+ */
+static void getChange(size_t M, const std::vector<std::vector<std::pair<double, size_t>>> &S,
+                      const std::vector<double> &T, const std::vector<size_t> &C,
+                      const std::vector<double> &propensities, std::vector<size_t> &row,
+                      double tau, std::mt19937_64 &generator, std::vector<size_t> &change);
 
 static void acceptLeap(double &t, double &tLastNetworkUpdate, double &tau, size_t M,
-                    ContactNetwork & contNetwork,
-                    std::vector<std::vector<std::pair<double, size_t>>> &S,
-                    std::vector<double> &T, std::vector<size_t> &C,
-                    std::vector<size_t> &row, std::vector<double> &propensities,
-                    const std::vector<size_t> &change,
-                    std::vector<std::pair<double, Edge>> &propAdd,
-                    std::vector<std::pair<double, Edge>> &propDel,
-                    std::mt19937_64 &generator);
+                    ContactNetwork & contNetwork, Workspace &workspace, std::mt19937_64 &generator);
 
 static void rejectLeap(size_t M,  double &tau, std::vector<std::vector<std::pair<double, size_t>>> &S,
                     const std::vector<double> &T, const std::vector<size_t> &C,
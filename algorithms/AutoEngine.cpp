@@ -0,0 +1,92 @@
+//
+// Automatic choice between SSA and SSATAN-X, see AutoEngine.h
+//
+
+#include <chrono>
+#include <ctime>
+#include <unistd.h>
+#include "AutoEngine.h"
+#include "utilities/TraceRecorder.h"
+
+AutoEngine::AutoEngine() : AutoEngine(::time(nullptr) * getpid()) //to change the seed for every run
+{
+}
+
+// both engines are seeded by time and pid otherwise, i.e. they would draw the same numbers
+AutoEngine::AutoEngine(std::mt19937_64::result_type seed) : ssa(seed), ssatanx(seed + 1)
+{
+}
+
+const char *AutoEngine::getEngineName(Engine engine)
+{
+    return engine == ExactSSA ? "SSA" : "SSX";
+}
+
+void AutoEngine::execute(double tStart, double tEnd, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                         size_t &nRejections, size_t &nAcceptance, size_t &nThin)
+{
+    double segment = (tEnd - tStart) / numberOfSegments;
+    double time = tStart;
+    Engine current = Thinning;
+    ssatanx.continueLookAhead(tStart, tEnd);
+    for (size_t k = 0; time < tEnd; k++)
+    {
+        // engines w/o cost yet are probed first, then the cheaper one runs and the other is probed regularly
+        Engine engine = current;
+        double length = segment;
+        if (cost[ExactSSA] < 0 || cost[Thinning] < 0)
+        {
+            engine = cost[Thinning] < 0 ? Thinning : ExactSSA;
+            length = segment * probeFraction;
+        }
+        else
+        {
+            current = cost[ExactSSA] < cost[Thinning] ? ExactSSA : Thinning;
+            engine = current;
+            if (k % probeInterval == 0)
+            {
+                engine = current == ExactSSA ? Thinning : ExactSSA;
+                length = segment * probeFraction;
+            }
+        }
+
+        double segmentEnd = tEnd - time > length ? time + length : tEnd;
+        executeSegment(engine, time, segmentEnd, contNetwork, nwStorage, nRejections, nAcceptance, nThin);
+        time = segmentEnd;
+    }
+    ssatanx.stopLookAhead();
+}
+
+void AutoEngine::executeSegment(Engine engine, double tStart, double tEnd, ContactNetwork &contNetwork,
+                                NetworkStorage &nwStorage, size_t &nRejections, size_t &nAcceptance, size_t &nThin)
+{
+    TraceRecorder::Span span(getEngineName(engine));
+    size_t nStored = nwStorage.size();
+
+    auto start = std::chrono::steady_clock::now();
+    if (engine == ExactSSA)
+    {
+        ssa.execute(tStart, tEnd, contNetwork, nwStorage);
+    }
+    else
+    {
+        ssatanx.execute(tStart, tEnd, contNetwork, nwStorage, nRejections, nAcceptance, nThin);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // every engine stores the state at its start and end. At the boundary of two segments both are the state after
+    // the last reaction, only the end of the last segment is kept
+    if (nStored > 1 && nwStorage[nStored - 1].first == tStart)
+    {
+        nwStorage.erase(nwStorage.begin() + nStored - 1, nwStorage.begin() + nStored + 1);
+    }
+    else if (nStored > 0)
+    {
+        nwStorage.erase(nwStorage.begin() + nStored);
+    }
+
+    cost[engine] = seconds / (tEnd - tStart);
+    statistics[engine].segments++;
+    statistics[engine].simulatedTime += tEnd - tStart;
+    statistics[engine].seconds += seconds;
+}
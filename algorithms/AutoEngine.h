@@ -0,0 +1,70 @@
+/*
+ * Automatic choice between SSA and SSATAN-X during a run. The simulated time is split into segments; every segment
+ * is simulated by the engine with the lower cost, i.e. wall-clock time per simulated time, measured on its last
+ * segment. The other engine is probed on a short segment regularly, so the choice follows the phase of the epidemic
+ * (SSATAN-X thins heavily when infections are widespread, exact stepping wins for tiny networks).
+ * Acceptance, rejection and thinning rates of SSATAN-X are not used for the choice, their cost is contained in the
+ * wall-clock time. The look-ahead policy of SSATAN-X is started once for the whole run and keeps its state across
+ * segments, e.g. windows of the horizon policy reach until the end of the run (@see SSATANX::continueLookAhead).
+ *
+ * SSA is exact, SSATAN-X approximates the contact dynamics by tau-leaping. Both start from the state of the network
+ * at the beginning of a segment and leave it updated until its end, and the choice depends only on the past, so the
+ * switching adds no error beyond the one of the engine of each segment. As the choice depends on timing, runs are
+ * not reproducible with a fixed seed.
+ */
+
+#ifndef ALGO_AUTOENGINE_H
+#define ALGO_AUTOENGINE_H
+
+#include <array>
+#include <random>
+#include "algorithms/SSA.h"
+#include "algorithms/SSATANX.h"
+#include "contact_network/ContactNetwork.h"
+#include "utilities/types.h"
+
+class AutoEngine
+{
+public:
+    enum Engine {ExactSSA, Thinning, NumberOfEngines};
+
+    /*
+     * simulated time and wall-clock time of the segments of an engine
+     */
+    struct EngineStatistics
+    {
+        size_t segments = 0;
+        double simulatedTime = 0;
+        double seconds = 0;
+    };
+
+    AutoEngine();
+    explicit AutoEngine(std::mt19937_64::result_type seed); //engines with fixed seeds, seed + 1 for SSATAN-X
+
+    SSATANX &getSSATANX() { return ssatanx; } // e.g. to set the look-ahead
+
+    void execute(double tStart, double tEnd, ContactNetwork &contNetwork,
+                 NetworkStorage &nwStorage, size_t &nRejections, size_t &nAcceptance, size_t &nThin);
+
+    const EngineStatistics &getStatistics(Engine engine) const { return statistics[engine]; }
+    static const char *getEngineName(Engine engine); //@return "SSA" or "SSX"
+
+private:
+    static constexpr size_t numberOfSegments = 64;
+    static constexpr size_t probeInterval = 8; // every probeInterval-th segment probes the other engine
+    static constexpr double probeFraction = 0.125; // length of a probe relative to a segment
+
+    /*
+     * simulates [tStart, tEnd] with the engine and updates its cost
+     */
+    void executeSegment(Engine engine, double tStart, double tEnd, ContactNetwork &contNetwork,
+                        NetworkStorage &nwStorage, size_t &nRejections, size_t &nAcceptance, size_t &nThin);
+
+    SSA ssa;
+    SSATANX ssatanx;
+
+    std::array<double, NumberOfEngines> cost {-1, -1}; // seconds per simulated time of the last segment, -1 unknown
+    std::array<EngineStatistics, NumberOfEngines> statistics {};
+};
+
+#endif //ALGO_AUTOENGINE_H
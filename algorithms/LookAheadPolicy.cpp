@@ -0,0 +1,105 @@
+//
+// Choice of the look-ahead window of SSATAN-X, see LookAheadPolicy.h
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "LookAheadPolicy.h"
+
+LookAheadPolicy::LookAheadPolicy(const LookAheadSettings &settings) : parameter(settings.parameter)
+{
+    if (settings.policy == "horizon")
+    {
+        kind = Horizon;
+    }
+    else if (settings.policy == "fixed")
+    {
+        kind = Fixed;
+    }
+    else if (settings.policy == "mean_event_time")
+    {
+        kind = MeanEventTime;
+    }
+    else if (settings.policy == "acceptance")
+    {
+        kind = Acceptance;
+    }
+    else
+    {
+        std::string msg = "Invalid look-ahead policy " + settings.policy;
+        throw std::domain_error(msg);
+    }
+}
+
+std::string LookAheadPolicy::getName() const
+{
+    switch (kind)
+    {
+        case Fixed:
+            return "fixed";
+        case MeanEventTime:
+            return "mean_event_time";
+        case Acceptance:
+            return "acceptance";
+        default:
+            return "horizon";
+    }
+}
+
+void LookAheadPolicy::start(double tStart, double tEnd)
+{
+    // the controller starts from the whole simulation and shrinks the window while proposals are thinned
+    maxWindow = tEnd - tStart;
+    window = maxWindow;
+}
+
+double LookAheadPolicy::getWindow(double time, double tEnd, double propensitySum) const
+{
+    double result = tEnd - time;
+    switch (kind)
+    {
+        case Fixed:
+            result = parameter;
+            break;
+        case MeanEventTime:
+            // w/o epidemic reactions, e.g. until the first contact between interacting states, the horizon is used
+            if (propensitySum > 0)
+            {
+                result = parameter / propensitySum;
+            }
+            break;
+        case Acceptance:
+            result = window;
+            break;
+        default:
+            break;
+    }
+    return std::min(result, tEnd - time);
+}
+
+/*
+ * the window is multiplied by e^(gain * (outcome - target)), outcome 1 for accepted and 0 for thinned proposals:
+ * it does not change on average if the ratio of accepted proposals is the target
+ */
+void LookAheadPolicy::onAccepted()
+{
+    if (kind == Acceptance)
+    {
+        window = std::min(window * std::exp(gain * (1 - parameter)), maxWindow);
+    }
+}
+
+void LookAheadPolicy::onThinned()
+{
+    if (kind == Acceptance)
+    {
+        window *= std::exp(-gain * parameter);
+    }
+}
+
+void LookAheadPolicy::onRejected()
+{
+    // the limit was not exceeded during the whole window, it is extended as after an accepted proposal
+    onAccepted();
+}
@@ -0,0 +1,50 @@
+/*
+ * Choice of the look-ahead window of SSATAN-X. The upper limit of propensities has to hold during the whole window:
+ * a long window gives a loose limit and many thinned proposals, a short one many windows without a proposal
+ * (rejections), each of them costs an evaluation of the limit. Policies:
+ *  - Horizon: until the end of the simulation, as in the original algorithm (default)
+ *  - Fixed: window of fixed length
+ *  - MeanEventTime: multiple of the current mean time between epidemic reactions, 1 / sum of their propensities
+ *  - Acceptance: controller which shrinks the window after thinned proposals and extends it after accepted ones
+ *    and rejections, so that the ratio of accepted proposals approaches a target
+ * The window is chosen before the proposal is sampled, so any policy keeps the simulation exact.
+ */
+
+#ifndef ALGO_LOOKAHEADPOLICY_H
+#define ALGO_LOOKAHEADPOLICY_H
+
+#include <string>
+#include "utilities/Settings.h"
+
+class LookAheadPolicy {
+public:
+    enum Kind {Horizon, Fixed, MeanEventTime, Acceptance};
+
+    LookAheadPolicy() = default;
+    explicit LookAheadPolicy(const LookAheadSettings &settings);
+
+    Kind getKind() const { return kind; }
+    std::string getName() const; //@return name of the policy as in the config
+
+    void start(double tStart, double tEnd); // resets the state of the policy for a simulation of [tStart, tEnd]
+
+    /*
+     * @param propensitySum current sum of propensities of the epidemic channels
+     * @return length of the next window, at most tEnd - time
+     */
+    double getWindow(double time, double tEnd, double propensitySum) const;
+
+    void onAccepted(); // proposal in the window was accepted
+    void onThinned(); // proposal in the window was thinned
+    void onRejected(); // no proposal in the window
+
+private:
+    static constexpr double gain = 0.2; // rate of adaptation of the controller, window changes by at most e^gain
+
+    Kind kind = Horizon;
+    double parameter = 0; // window / factor / target acceptance ratio
+    double window = 0; // current window of the controller
+    double maxWindow = 0; // length of the simulation
+};
+
+#endif //ALGO_LOOKAHEADPOLICY_H
@@ -0,0 +1,163 @@
+//
+// Parameter sweep, see ParameterSweep.h
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "ParameterSweep.h"
+#include "algorithms/Simulation.h"
+#include "utilities/Output.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/TraceRecorder.h"
+
+void ParameterSweep::execute(const Settings &settings, const std::string &mode)
+{
+    if (!Simulation::isAlgorithm(mode))
+    {
+        std::string msg = "Invalid algorthm specified";
+        throw std::domain_error(msg);
+    }
+
+    SweepSettings sweepSettings = settings.getSweepSettings();
+    std::vector<Settings> points = settings.expandSweep();
+    size_t nReplicates = sweepSettings.replicates;
+
+    // replicates must differ even if no seed is given
+    uint baseSeed = settings.getSeed();
+    if (baseSeed == 0)
+    {
+        baseSeed = std::random_device{}() | 1u;
+    }
+
+    std::vector<size_t> groupSizes;
+    std::vector<size_t> groups = groupByTopology(points, groupSizes);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto const filename = std::chrono::system_clock::now().time_since_epoch().count();
+
+    ThreadPool pool(sweepSettings.threads);
+    std::unique_ptr<TraceRecorder> trace = settings.hasTrace() ? std::make_unique<TraceRecorder>(settings.getTraceFile()) : nullptr;
+
+    // build initial networks shared by several points, once per replicate
+    std::vector<std::vector<std::unique_ptr<ImportedNetwork>>> networks(groupSizes.size());
+    for (size_t g = 0; g < groupSizes.size(); g++)
+    {
+        networks.at(g).resize(nReplicates);
+        if (groupSizes.at(g) < 2)
+        {
+            continue;
+        }
+
+        size_t representative = std::distance(groups.begin(), std::find(groups.begin(), groups.end(), g));
+        for (size_t r = 0; r < nReplicates; r++)
+        {
+            pool.submit([&, g, r, representative]()
+            {
+                Settings replicateSettings = points.at(representative);
+                replicateSettings.setSeed(baseSeed + r);
+                ContactNetwork contNetwork(replicateSettings);
+                networks.at(g).at(r) = std::make_unique<ImportedNetwork>(contNetwork.exportNetwork());
+            });
+        }
+    }
+    pool.wait();
+
+    std::vector<std::vector<nlohmann::ordered_json>> results(points.size(),
+                                                             std::vector<nlohmann::ordered_json>(nReplicates));
+    for (size_t p = 0; p < points.size(); p++)
+    {
+        for (size_t r = 0; r < nReplicates; r++)
+        {
+            pool.submit([&, p, r]()
+            {
+                Settings replicateSettings = points.at(p);
+                replicateSettings.setSeed(baseSeed + r);
+
+                std::seed_seq seq{static_cast<size_t>(baseSeed), p, r};
+                std::vector<std::mt19937_64::result_type> engineSeed(1);
+                seq.generate(engineSeed.begin(), engineSeed.end());
+
+                TraceRecorder::Scope traceScope(trace.get(), "point " + std::to_string(p) + " replicate " + std::to_string(r));
+                runReplicate(replicateSettings, networks.at(groups.at(p)).at(r).get(), mode, engineSeed.at(0),
+                             results.at(p).at(r));
+            });
+        }
+    }
+    pool.wait();
+    if (trace)
+    {
+        trace->flush();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto time = end_time - start_time;
+
+    nlohmann::ordered_json output;
+    output["algorithm"] = mode.substr(1);
+    output["seed"] = baseSeed;
+    output["replicates"] = nReplicates;
+    output["threads"] = pool.size();
+    output["shared_initial_networks"] = std::count_if(groupSizes.begin(), groupSizes.end(),
+                                                      [](size_t n) { return n > 1; }) * nReplicates;
+    output["duration_in_milliseconds"] = std::chrono::duration <double, std::milli> (time).count();
+    for (size_t p = 0; p < points.size(); p++)
+    {
+        const Settings &point = points.at(p);
+        output["points"][p]["transmission_rate"] = point.getTransmissionRate();
+        output["points"][p]["diagnosis_rate"] = point.getDiagnosisRate();
+        output["points"][p]["rate_of_make_a_new_contact"] = {point.getNewConactRateParameters().a,
+                                                              point.getNewConactRateParameters().b};
+        output["points"][p]["rate_of_loose_a_contact"] = {point.getLooseConactRateParameters().a,
+                                                           point.getLooseConactRateParameters().b};
+        output["points"][p]["replicates"] = std::move(results.at(p));
+    }
+
+    std::string fileName = "SWEEP_" + mode.substr(1) + "_" + std::to_string(filename) + ".txt";
+
+    std::ofstream newFile;
+    newFile.open(fileName);
+    newFile <<  output << std::endl;
+    newFile.close();
+}
+
+void ParameterSweep::runReplicate(const Settings &settings, const ImportedNetwork *initialNetwork,
+                                  const std::string &mode, std::mt19937_64::result_type seed,
+                                  nlohmann::ordered_json &output)
+{
+    std::unique_ptr<ContactNetwork> contNetwork = initialNetwork == nullptr ?
+            std::make_unique<ContactNetwork>(settings) : std::make_unique<ContactNetwork>(settings, *initialNetwork);
+
+    output["seed"] = settings.getSeed();
+    saveInitialStates(output, *contNetwork, settings);
+
+    NetworkStorage nwStorage;
+    Simulation::run(mode, settings, &seed, 1, *contNetwork, nwStorage, output);
+}
+
+std::vector<size_t> ParameterSweep::groupByTopology(const std::vector<Settings> &points, std::vector<size_t> &groupSizes)
+{
+    std::vector<size_t> groups(points.size());
+    std::vector<size_t> representatives;
+    for (size_t p = 0; p < points.size(); p++)
+    {
+        auto it = std::find_if(representatives.begin(), representatives.end(),
+                               [&](size_t rep) { return points.at(rep).isSameTopology(points.at(p)); });
+        if (it == representatives.end())
+        {
+            groups.at(p) = representatives.size();
+            representatives.push_back(p);
+            groupSizes.push_back(1);
+        }
+        else
+        {
+            groups.at(p) = std::distance(representatives.begin(), it);
+            groupSizes.at(groups.at(p))++;
+        }
+    }
+    return groups;
+}
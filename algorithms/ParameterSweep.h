@@ -0,0 +1,45 @@
+/*
+ * Parameter sweep: runs all (point x replicate) simulations of a sweep grid on a shared thread pool
+ * and writes one consolidated result file.
+ *
+ * Replicate r of every point uses seed (seed + r), so points that differ only in epidemic parameters
+ * (transmission & diagnosis rates) start from the same initial network. Such networks are built once
+ * per replicate and shared between the points.
+ */
+
+#ifndef ALGO_PARAMETERSWEEP_H
+#define ALGO_PARAMETERSWEEP_H
+
+#include <string>
+#include <vector>
+#include "nlohmann/json.h"
+#include "contact_network/ContactNetwork.h"
+#include "utilities/Settings.h"
+
+class ParameterSweep {
+public:
+    /*
+     * @param mode algorithm to use: "-SSA", "-SSX", "-AUTO" or "-TAU"
+     */
+    static void execute(const Settings &settings, const std::string &mode);
+
+private:
+
+    ParameterSweep(){};
+
+    /*
+     * runs one replicate of a point and writes its result to output.
+     * @param initialNetwork shared initial network, nullptr if network has to be created from settings
+     */
+    static void runReplicate(const Settings &settings, const ImportedNetwork *initialNetwork,
+                             const std::string &mode, std::mt19937_64::result_type seed,
+                             nlohmann::ordered_json &output);
+
+    /*
+     * groups points by topology
+     * @return index of the group of each point
+     */
+    static std::vector<size_t> groupByTopology(const std::vector<Settings> &points, std::vector<size_t> &groupSizes);
+};
+
+#endif //ALGO_PARAMETERSWEEP_H
@@ -8,56 +8,46 @@
 #include <chrono>
 #include "SSA.h"
 #include "utilities/Utility.h"
-
-std::mt19937_64 SSA::generator{std::random_device{}()};
+#include "utilities/Profiler.h"
 
 SSA::SSA()
 {
     generator.seed(::time(nullptr) * getpid()); //to change the seed for every run
 }
 
+SSA::SSA(std::mt19937_64::result_type seed) : generator(seed)
+{
+}
+
 void SSA::execute(double tStart, double tEnd, ContactNetwork &contNetwork,
                   NetworkStorage &nwStorage)
 {
-    std::vector<std::pair<double, Edge>> propDel;
-    std::vector<std::pair<double, Edge>> propAdd;
-    std::vector<std::pair<double, Edge>> propTransmit;
-    std::vector<std::pair<double, Node>> propDiagnos;
-    std::vector<std::pair<double, Node>> propDeath;
-
-    std::unordered_map<std::string, double >propensities {
-            {"edge_del", 0},
-            {"edge_add", 0},
-            {"transmission", 0},
-            {"diagnosis", 0},
-            {"death", 0}
-            //{"birth", 0},
-    };
+    if (contNetwork.getModel().isBuiltIn())
+    {
+        executeModel<SIDModel>(tStart, tEnd, contNetwork, nwStorage);
+    }
+    else
+    {
+        executeModel<DynamicModel>(tStart, tEnd, contNetwork, nwStorage);
+    }
+}
 
+template <typename ModelPolicy>
+void SSA::executeModel(double tStart, double tEnd, ContactNetwork &contNetwork,
+                       NetworkStorage &nwStorage)
+{
+    const Model &model = contNetwork.getModel();
+    auto update = [&](Model::Channel channel) { updatePropensity(contNetwork, channel); };
 
     double time = tStart;
 
     nwStorage.emplace_back(time, contNetwork.getNetworkState());
 
+    forEachChannel(SIDModel::allChannels, update);
+
     while (time < tEnd)
     {
-        propDel = contNetwork.getEdgeDeletionRateSum();
-        propAdd = contNetwork.getEdgeAdditionRateSum();
-        propTransmit = contNetwork.getTransmissionRateSum();
-        propDiagnos = contNetwork.getDiagnosisRateSum();
-        propDeath = contNetwork.getDeathRateSum();
-
-        propensities.at("edge_del") = propDel.back().first;
-        propensities.at("edge_add") = propAdd.back().first;
-
-        propensities.at("transmission") = propTransmit.back().first;
-        propensities.at("diagnosis") = propDiagnos.back().first;
-        propensities.at("death") = propDeath.back().first;
-
-        //propensities.at("birth") = contNetwork.getBirthRateSum();
-
-
-        double propensitieSum = std::accumulate(propensities.begin(), propensities.end(), 0.0, [](double value, const std::unordered_map<std::string, double >::value_type &b){return value + b.second;});
+        double propensitieSum = std::accumulate(propensities.begin(), propensities.end(), 0.0);
 
         if (propensitieSum == 0)
         {
@@ -77,66 +67,124 @@ void SSA::execute(double tStart, double tEnd, ContactNetwork &contNetwork,
         {
             time += proposedTime;
             r = sampleRandUni(generator);
+            double searchBound = propensitieSum * r;
             double pSum = 0;
-            for (auto const &it: propensities)
+            size_t selected = selectChannel(propensities, searchBound, pSum);
+            if (selected == Model::NumberOfChannels)
             {
+                continue;
+            }
 
-                if (pSum + it.second >= propensitieSum * r)
-                {
-                    executeReaction(contNetwork, it.first, pSum, propensitieSum * r, time,
-                                    propDel, propAdd, propTransmit, propDiagnos, propDeath, nwStorage);
-                    break;
-                }
-                pSum += it.second;
+            Model::Channel channel = static_cast<Model::Channel>(selected);
+            bool homogeneousContacts = contNetwork.hasHomogeneousContacts();
+            executeReaction(contNetwork, channel, searchBound - pSum, time);
+            if (Model::isEpidemic(channel))
+            {
+                nwStorage.emplace_back(time, contNetwork.getNetworkState());
+            }
+
+            // only propensities of the channels affected by the reaction change
+            forEachChannel(ModelPolicy::getDependencies(model, channel), update);
+            if (homogeneousContacts && !contNetwork.hasHomogeneousContacts())
+            {
+                // contact channels leave the fast path, cumulative sums are needed from now on
+                forEachChannel((1u << Model::EdgeDeletion) | (1u << Model::EdgeAddition), update);
             }
         }
     }
 }
 
-void SSA::executeReaction(ContactNetwork & contNetwork, const std::string &reactId, double rStart,
-                          double rBound, double time,
-                          std::vector<std::pair<double, Edge>> &propDel,
-                          std::vector<std::pair<double, Edge>> &propAdd,
-                          std::vector<std::pair<double, Edge>> &propTransmit,
-                          std::vector<std::pair<double, Node>> &propDiagnos,
-                          std::vector<std::pair<double, Node>> &propDeath,
-                          NetworkStorage &nwStorage)
-{
-    if (reactId == "edge_del")
-    {
-        auto edgeIterator = std::lower_bound(propDel.begin(), propDel.end(), rBound - rStart, lambdaLess);
-        contNetwork.removeEdge(edgeIterator->second);
-    }
+template void SSA::executeModel<SIDModel>(double, double, ContactNetwork &, NetworkStorage &);
+template void SSA::executeModel<DynamicModel>(double, double, ContactNetwork &, NetworkStorage &);
 
-    else if (reactId == "edge_add")
-    {
-        auto edgeIterator = std::lower_bound(propAdd.begin(), propAdd.end(), rBound - rStart, lambdaLess);
-        contNetwork.addEdge(edgeIterator->second);
-    }
-    else if (reactId == "transmission")
-    {
-        auto edgeIterator = std::lower_bound(propTransmit.begin(), propTransmit.end(), rBound - rStart, lambdaLess);
-        contNetwork.executeTransmission(edgeIterator->second, time);
-
-        nwStorage.emplace_back(time, contNetwork.getNetworkState());
-    }
-
-    else if (reactId == "diagnosis")
+void SSA::updatePropensity(ContactNetwork & contNetwork, Model::Channel channel)
+{
+    Profiler::Timer timer(Profiler::PropensityUpdate);
+    switch (channel)
     {
-        auto nodeIterator = std::lower_bound(propDiagnos.begin(), propDiagnos.end(), rBound - rStart, lambdaLess);
-        contNetwork.executeDiagnosis(nodeIterator->second, time);
-        nwStorage.emplace_back(time, contNetwork.getNetworkState());
+        case Model::EdgeDeletion:
+            if (contNetwork.hasHomogeneousContacts())
+            {
+                propensities[channel] = contNetwork.getEdgeDeletionPropensity();
+                break;
+            }
+            contNetwork.getEdgeDeletionRateSum(propDel);
+            propensities[channel] = propDel.back().first;
+            break;
+        case Model::EdgeAddition:
+            if (contNetwork.hasHomogeneousContacts())
+            {
+                propensities[channel] = contNetwork.getEdgeAdditionPropensity();
+                break;
+            }
+            contNetwork.getEdgeAdditionRateSum(propAdd);
+            propensities[channel] = propAdd.back().first;
+            break;
+        case Model::Interaction:
+            propensities[channel] = contNetwork.getInteractionPropensity();
+            break;
+        case Model::Transition:
+            propensities[channel] = contNetwork.getTransitionPropensity();
+            break;
+        case Model::Death:
+            propensities[channel] = contNetwork.getDeathPropensity();
+            break;
+        case Model::Birth:
+            propensities[channel] = contNetwork.getBirthRateSum();
+            break;
     }
+}
 
-    else if (reactId == "death")
+void SSA::executeReaction(ContactNetwork & contNetwork, Model::Channel channel, double rBound, double time)
+{
+    Profiler::Timer timer(Profiler::ReactionExecution);
+    Profiler::count(Model::isEpidemic(channel) ? Profiler::EpidemicReactions : Profiler::ContactReactions);
+    switch (channel)
     {
-        auto nodeIterator = std::lower_bound(propDeath.begin(), propDeath.end(), rBound - rStart, lambdaLess);
-        contNetwork.executeDeath(nodeIterator->second);
-        nwStorage.emplace_back(time, contNetwork.getNetworkState());
+        case Model::EdgeDeletion:
+        {
+            if (contNetwork.hasHomogeneousContacts())
+            {
+                Edge edge = contNetwork.sampleEdgeDeletion(generator);
+                contNetwork.removeEdge(edge);
+                break;
+            }
+            auto edgeIterator = std::lower_bound(propDel.begin(), propDel.end(), rBound, lambdaLess);
+            contNetwork.removeEdge(edgeIterator->second);
+            break;
+        }
+        case Model::EdgeAddition:
+        {
+            if (contNetwork.hasHomogeneousContacts())
+            {
+                Edge edge = contNetwork.sampleEdgeAddition(generator);
+                contNetwork.addEdge(edge);
+                break;
+            }
+            auto edgeIterator = std::lower_bound(propAdd.begin(), propAdd.end(), rBound, lambdaLess);
+            contNetwork.addEdge(edgeIterator->second);
+            break;
+        }
+        case Model::Interaction:
+        {
+            auto [edge, r] = contNetwork.findInteraction(rBound);
+            contNetwork.executeInteraction(edge, r, time);
+            break;
+        }
+        case Model::Transition:
+        {
+            auto [node, r] = contNetwork.findTransition(rBound);
+            contNetwork.executeTransition(node, r, time);
+            break;
+        }
+        case Model::Death:
+        {
+            Node node = contNetwork.findDeath(rBound).first;
+            contNetwork.executeDeath(node);
+            break;
+        }
+        case Model::Birth:
+            contNetwork.executeBirth(time, generator);
+            break;
     }
-
-    /*else if (reactId == "birth")
-    {
-        //contNetwork.executeBirth(rStart, rBound);
-    }*/
-}
\ No newline at end of file
+}
@@ -9,33 +9,50 @@
 #define ALGO_SSA_H
 
 
+#include <array>
 #include <random>
 #include <vector>
 
 #include "contact_network/ContactNetwork.h"
+#include "model/ModelPolicies.h"
 #include "utilities/types.h"
 
 class SSA
 {
 public:
     SSA();
+    explicit SSA(std::mt19937_64::result_type seed); //engine with fixed seed, e.g. for replicates of a sweep
     void execute(double tStart, double tEnd, ContactNetwork &contNetwork,
                  NetworkStorage &nwStorage);
+
+    /*
+     * simulation specialised for the model policy (@see ModelPolicies.h),
+     * execute() uses SIDModel for the built-in model and DynamicModel otherwise
+     */
+    template <typename ModelPolicy>
+    void executeModel(double tStart, double tEnd, ContactNetwork &contNetwork,
+                      NetworkStorage &nwStorage);
     ~SSA() = default;
 
 private:
 
-    void   executeReaction(ContactNetwork & contNetwork, const std::string &reactId, double rStart,
-                           double rBound, double time,
-                            std::vector<std::pair<double, lemon::ListGraph::Edge>> &propDel,
-                            std::vector<std::pair<double, lemon::ListGraph::Edge>> &propAdd,
-                            std::vector<std::pair<double, lemon::ListGraph::Edge>> &propTransmit,
-                            std::vector<std::pair<double, Node>> &propDiagnos,
-                            std::vector<std::pair<double, Node>> &propDeath,
-                           NetworkStorage &nwStorage);
+    /*
+     * recalculates propensity of the channel and its cumulative sums of rates if it needs them
+     */
+    void updatePropensity(ContactNetwork & contNetwork, Model::Channel channel);
+
+    /*
+     * executes reaction of the channel.
+     * @param rBound value in (0, propensity of the channel], used to find the edge/node and the reaction
+     */
+    void   executeReaction(ContactNetwork & contNetwork, Model::Channel channel, double rBound, double time);
 
 private:
-    static std::mt19937_64 generator;
+    std::mt19937_64 generator;
+
+    std::array<double, Model::NumberOfChannels> propensities {};
+    std::vector<std::pair<double, Edge>> propDel;
+    std::vector<std::pair<double, Edge>> propAdd;
 };
 
 
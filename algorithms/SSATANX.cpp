@@ -4,23 +4,69 @@
 
 #include <cmath>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <fstream>
 #include <unistd.h>
 #include "SSATANX.h"
 #include "utilities/Utility.h"
+#include "utilities/Profiler.h"
+#include "utilities/ThreadPool.h"
 #include "algorithms/AndersonTauLeap.h"
 
-std::mt19937_64 SSATANX::generator{std::random_device{}()};
-
 SSATANX::SSATANX()
 {
     generator.seed(::time(nullptr) * getpid()); //to change the seed for every run
 }
 
+SSATANX::SSATANX(std::mt19937_64::result_type seed) : generator(seed)
+{
+}
+
+SSATANX::SSATANX(SSATANX &&) noexcept = default;
+
+SSATANX::~SSATANX() = default;
+
+void SSATANX::setLookAheadThreads(size_t nThreads)
+{
+    lookAheadPool = nThreads == 1 ? nullptr : std::make_unique<ThreadPool>(nThreads);
+}
+
+void SSATANX::setLookAheadPolicy(const LookAheadPolicy &policy)
+{
+    lookAheadPolicy = policy;
+}
+
+void SSATANX::continueLookAhead(double tStart, double tEnd)
+{
+    lookAheadPolicy.start(tStart, tEnd);
+    lookAheadEnd = tEnd;
+}
+
+void SSATANX::stopLookAhead()
+{
+    lookAheadEnd = -1;
+}
+
 void SSATANX::execute(double tStart, double tEnd, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
                    size_t &nRejections, size_t &nAcceptance, size_t &nThin)
 {
+    if (contNetwork.getModel().isBuiltIn())
+    {
+        executeModel<SIDModel>(tStart, tEnd, contNetwork, nwStorage, nRejections, nAcceptance, nThin);
+    }
+    else
+    {
+        executeModel<DynamicModel>(tStart, tEnd, contNetwork, nwStorage, nRejections, nAcceptance, nThin);
+    }
+}
+
+template <typename ModelPolicy>
+void SSATANX::executeModel(double tStart, double tEnd, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                           size_t &nRejections, size_t &nAcceptance, size_t &nThin)
+{
+    const Model &model = contNetwork.getModel();
+
     double time = tStart;
 
     nwStorage.emplace_back(time, contNetwork.getNetworkState());
@@ -30,27 +76,36 @@ void SSATANX::execute(double tStart, double tEnd, ContactNetwork &contNetwork, N
     double networkLastUpdate = tStart;
 
     double proposedTime = -1;
-    std::vector<std::pair<double, Edge>> propTransmit = contNetwork.getTransmissionRateSum();
-    std::vector<std::pair<double, Node>> propDeath = contNetwork.getDeathRateSum();
-    std::vector<std::pair<double, Node>> propDiagnos = contNetwork.getDiagnosisRateSum();
-
-    std::unordered_map<std::string, double >propensities{
-            {"transmission", propTransmit.back().first},
-            {"diagnosis",propDiagnos.back().first},
-            {"death", propDeath.back().first}
-            //{"birth", contNetwork.getBirthRateSum()},
-    };
+
+    // contact channels are handled by tau-leaping
+    constexpr unsigned epidemicChannels = (1u << Model::Interaction) | (1u << Model::Transition) | (1u << Model::Death)
+                                        | (1u << Model::Birth);
+    auto update = [&](Model::Channel channel) { updatePropensity(contNetwork, channel); };
+    forEachChannel(epidemicChannels, update);
+    // windows of a run continued over several calls may reach beyond tEnd, @see continueLookAhead
+    double windowEnd = lookAheadEnd > tEnd ? lookAheadEnd : tEnd;
+    if (lookAheadEnd < 0)
+    {
+        lookAheadPolicy.start(tStart, tEnd);
+    }
 
     while (time < tEnd)
     {
+        TraceRecorder::Span span("iteration");
+
         //choose look-ahead time
-        lookAheadTime = tEnd - time;
-        propUpperLimit = getPropUpperLimit(lookAheadTime, contNetwork,
-                                           propDiagnos.back().first,
-                                           propDeath.back().first);
+        lookAheadTime = lookAheadPolicy.getWindow(time, windowEnd,
+                                                  std::accumulate(propensities.begin(), propensities.end(), 0.0));
+        // the network is not updated after a rejection, so contacts are limited from its last update on
+        propUpperLimit = getPropUpperLimit<ModelPolicy>(lookAheadTime + (time - networkLastUpdate), contNetwork,
+                                           propensities[Model::Transition],
+                                           propensities[Model::Death],
+                                           propensities[Model::Birth]);
         if (propUpperLimit == 0)
         {
+            // no epidemic reaction until the end, contacts still change
             time = tEnd;
+            Anderson::AndersonTauLeap(networkLastUpdate, time, contNetwork, generator, tauLeapWorkspace);
             nwStorage.emplace_back(time, contNetwork.getNetworkState());
             break;
         }
@@ -62,25 +117,33 @@ void SSATANX::execute(double tStart, double tEnd, ContactNetwork &contNetwork, N
             if (proposedTime > lookAheadTime)
             {
                 nRejections ++;
-                time += lookAheadTime;
-
+                lookAheadPolicy.onRejected();
+                if (lookAheadTime < tEnd - time)
+                {
+                    time += lookAheadTime; // nothing happened, the state is not stored again
+                }
+                else
+                {
+                    time = tEnd;
+                    Anderson::AndersonTauLeap(networkLastUpdate, time, contNetwork, generator, tauLeapWorkspace);
+                    nwStorage.emplace_back(time, contNetwork.getNetworkState());
+                }
+            }
+            else if (proposedTime > tEnd - time)
+            {
+                // the window reaches beyond tEnd, nothing happens until tEnd (proposals are memoryless)
+                time = tEnd;
+                Anderson::AndersonTauLeap(networkLastUpdate, time, contNetwork, generator, tauLeapWorkspace);
                 nwStorage.emplace_back(time, contNetwork.getNetworkState());
             }
             else
             {
                 time += proposedTime;
-                Anderson::AndersonTauLeap(networkLastUpdate, time, contNetwork, generator);
+                Anderson::AndersonTauLeap(networkLastUpdate, time, contNetwork, generator, tauLeapWorkspace);
                 networkLastUpdate = time;
-                propTransmit = contNetwork.getTransmissionRateSum();
-                propensities.at("transmission") = propTransmit.back().first;
-                propDiagnos = contNetwork.getDiagnosisRateSum();
-                propensities.at("diagnosis") = propDiagnos.back().first;
-                propDeath = contNetwork.getDeathRateSum();
-                propensities.at("death") = propDeath.back().first;
-                //propensities.at("birth") = contNetwork.getBirthRateSum();
+                forEachChannel(epidemicChannels, update);
 
-                double propensitieSum = std::accumulate(propensities.begin(), propensities.end(), 0.0, [] (double value, const std::map<std::string, double>::value_type& p)
-                { return value + p.second; });
+                double propensitieSum = std::accumulate(propensities.begin(), propensities.end(), 0.0);
 
                 r = sampleRandUni(generator);
 
@@ -89,42 +152,24 @@ void SSATANX::execute(double tStart, double tEnd, ContactNetwork &contNetwork, N
                 if (propensitieSum >= searchBound)
                 {
                     nAcceptance ++;
+                    lookAheadPolicy.onAccepted();
                     double pSum = 0;
-
-                    for (auto &it: propensities)
+                    size_t selected = selectChannel(propensities, searchBound, pSum);
+                    if (selected != Model::NumberOfChannels)
                     {
+                        Model::Channel channel = static_cast<Model::Channel>(selected);
+                        executeReaction(contNetwork, channel, searchBound - pSum, time);
 
-                        if (pSum + it.second >= searchBound)
-                        {
-                            if (it.first == "diagnosis")
-                            {
-                                networkLastUpdate = time;
-                            }
-                            executeReaction(contNetwork, it.first, pSum, searchBound, time,
-                                    propTransmit,propDiagnos,propDeath);
-
-                            nwStorage.emplace_back(time, contNetwork.getNetworkState());
-
-                            propTransmit = contNetwork.getTransmissionRateSum();
-                            propensities.at("transmission") = propTransmit.back().first;
-
-                            propDeath = contNetwork.getDeathRateSum();
-                            propensities.at("death") = propDeath.back().first;
-
-                            propDiagnos = contNetwork.getDiagnosisRateSum();
-                            propensities.at("diagnosis") = propDiagnos.back().first;
-
-                            //propensities.at("birth") = contNetwork.getBirthRateSum();
-
-                            break;
-                        }
-                        pSum += it.second;
+                        nwStorage.emplace_back(time, contNetwork.getNetworkState());
 
+                        // contact channels are recalculated by the next tau-leap anyway
+                        forEachChannel(ModelPolicy::getDependencies(model, channel) & epidemicChannels, update);
                     }
                 }
                 else
                 {
                    nThin++;
+                   lookAheadPolicy.onThinned();
                 }
 
             }
@@ -133,91 +178,240 @@ void SSATANX::execute(double tStart, double tEnd, ContactNetwork &contNetwork, N
 }
 
 double  SSATANX::getPropUpperLimit_naive (ContactNetwork & contNetwork,
-                                 double diagnosisUpperLimit, double deathUpperLimit) const
+                                 double transitionUpperLimit, double deathUpperLimit, double birthUpperLimit) const
+{
+    double result = transitionUpperLimit + deathUpperLimit + birthUpperLimit;
+    for (const Model::InteractionPair &pair: contNetwork.getModel().getInteractionPairs())
+    {
+        result += pair.rate * contNetwork.countByState(pair.anchor) * contNetwork.countByState(pair.partner);
+    }
+    return result;
+}
+
+template void SSATANX::executeModel<SIDModel>(double, double, ContactNetwork &, NetworkStorage &,
+                                             size_t &, size_t &, size_t &);
+template void SSATANX::executeModel<DynamicModel>(double, double, ContactNetwork &, NetworkStorage &,
+                                                 size_t &, size_t &, size_t &);
+
+double SSATANX::getInteractionUpperLimit(double lookAheadTime, ContactNetwork &contNetwork)
+{
+    if (contNetwork.getModel().isBuiltIn())
+    {
+        return getSIDInteractionLimit(lookAheadTime, contNetwork);
+    }
+    return getInteractionLimit(lookAheadTime, contNetwork);
+}
+
+template <typename ModelPolicy>
+double  SSATANX::getPropUpperLimit (double lookAheadTime, ContactNetwork & contNetwork, double transitionUpperLimit,
+                                    double deathUpperLimit, double birthUpperLimit)
 {
-    return (contNetwork.countByState(Specie::I) * contNetwork.getTransmissionRateLimit() +
-            contNetwork.countByState(Specie::D) * contNetwork.getTransmissionRateLimit() * 0.5) *
-           contNetwork.countByState(Specie::S) + diagnosisUpperLimit +
-            deathUpperLimit;
+    Profiler::Timer timer(Profiler::LookAhead);
+    if constexpr (ModelPolicy::builtIn)
+    {
+        return transitionUpperLimit + deathUpperLimit + birthUpperLimit + getSIDInteractionLimit(lookAheadTime, contNetwork);
+    }
+    else
+    {
+        return transitionUpperLimit + deathUpperLimit + birthUpperLimit + getInteractionLimit(lookAheadTime, contNetwork);
+    }
 }
 
-double  SSATANX::getPropUpperLimit (double lookAheadTime, ContactNetwork & contNetwork, double diagnosisUpperLimit, double deathUpperLimit) const
+double  SSATANX::getSIDInteractionLimit (double lookAheadTime, ContactNetwork & contNetwork)
 {
-    //get estimation of the Max.contacts based on rates
-    size_t numberOfInfected = contNetwork.countByState(Specie::I);
-    size_t numberOfDiagnosed = contNetwork.countByState(Specie::D);
-    size_t numberOfSusceptible = contNetwork.countByState(Specie::S);
+    constexpr double factor = SIDModel::diagnosedTransmissionFactor;
+    double transmissionRate = contNetwork.getModel().getInteractionRate(SIDModel::susceptible, SIDModel::infected);
 
-    double maxContInfected = contNetwork.getMaxContactsLimitByState(Specie::I, lookAheadTime);
-    maxContInfected  = std::min(maxContInfected, static_cast<double>(numberOfSusceptible * numberOfInfected));
+    //get estimation of the Max.contacts based on rates, each node has at most all possible partners as contacts
+    double numberOfInfected = contNetwork.countByState(SIDModel::infected);
+    double numberOfDiagnosed = contNetwork.countByState(SIDModel::diagnosed);
+    double numberOfSusceptible = contNetwork.countByState(SIDModel::susceptible);
 
-    double maxContDiagnosed = contNetwork.getMaxContactsLimitByState(Specie::D, lookAheadTime);
-    maxContDiagnosed  = std::min(maxContDiagnosed, static_cast<double>(numberOfSusceptible * numberOfDiagnosed));
+    const std::vector<double> &maxContacts = contNetwork.getInteractingContactsLimits(lookAheadTime, limitsWorkspace,
+                                                                                     lookAheadPool.get());
 
-    double maxContSusceptible = contNetwork.getMaxContactsLimitByState(Specie::S, lookAheadTime);
+    double maxContInfected = maxContacts[SIDModel::infected];
+    maxContInfected  = std::min(maxContInfected, numberOfSusceptible * numberOfInfected);
 
-    maxContSusceptible = std::min(maxContSusceptible, static_cast<double>(numberOfSusceptible * (numberOfInfected + numberOfDiagnosed)));
+    double maxContDiagnosed = maxContacts[SIDModel::diagnosed];
+    maxContDiagnosed  = std::min(maxContDiagnosed, numberOfSusceptible * numberOfDiagnosed);
 
-    double limit1 = 0;
+    double maxContSusceptible = maxContacts[SIDModel::susceptible];
+    maxContSusceptible = std::min(maxContSusceptible, numberOfSusceptible * (numberOfInfected + numberOfDiagnosed));
 
+    double limit1 = 0;
     if (maxContInfected + maxContDiagnosed <= maxContSusceptible)
     {
-        limit1 = maxContInfected  * contNetwork.getTransmissionRateLimit() + maxContDiagnosed * contNetwork.getTransmissionRateLimit() * 0.5;
+        limit1 = maxContInfected * transmissionRate + maxContDiagnosed * transmissionRate * factor;
     }
     else if (maxContSusceptible <= maxContInfected)
     {
-        limit1 = maxContSusceptible * contNetwork.getTransmissionRateLimit();
+        limit1 = maxContSusceptible * transmissionRate;
     }
     else
     {
-        limit1 = maxContInfected * contNetwork.getTransmissionRateLimit() + (maxContSusceptible - maxContInfected) * contNetwork.getTransmissionRateLimit() * 0.5;
+        limit1 = maxContInfected * transmissionRate + (maxContSusceptible - maxContInfected) * transmissionRate * factor;
     }
 
     //get estimation of the Max. possible contacts based on number of species.
+    double maxContEsteem = (numberOfInfected + numberOfDiagnosed) * numberOfSusceptible;
+    double limit2 = numberOfInfected * numberOfSusceptible * transmissionRate +
+                    numberOfDiagnosed * numberOfSusceptible * transmissionRate * factor;
 
-    size_t maxContEsteem = (numberOfInfected + numberOfDiagnosed) * numberOfSusceptible;
-
-    double limit2 = numberOfInfected * numberOfSusceptible * contNetwork.getTransmissionRateLimit() +
-             numberOfDiagnosed * numberOfSusceptible * contNetwork.getTransmissionRateLimit() * 0.5;
-
-    double result = diagnosisUpperLimit + deathUpperLimit;
     if (std::min(maxContInfected + maxContDiagnosed, maxContSusceptible) < maxContEsteem)
     {
-        result += limit1;
+        return limit1;
     }
-    else
+    return limit2;
+}
+
+double  SSATANX::getInteractionLimit (double lookAheadTime, ContactNetwork & contNetwork)
+{
+    const Model &model = contNetwork.getModel();
+    const std::vector<Model::InteractionPair> &interactionPairs = model.getInteractionPairs();
+
+    numberOfSpecies.assign(model.getNumberOfStates(), -1);
+    const std::vector<double> *maxContacts = nullptr;
+    auto getNumberOfSpecies = [&](Specie::State st)
+    {
+        if (numberOfSpecies[st] < 0)
+        {
+            numberOfSpecies[st] = static_cast<double>(contNetwork.countByState(st));
+        }
+        return numberOfSpecies[st];
+    };
+    //get estimation of the Max.contacts with possible partners based on rates, for all states at once
+    auto getMaxContacts = [&](Specie::State st)
+    {
+        if (maxContacts == nullptr)
+        {
+            maxContacts = &contNetwork.getInteractingContactsLimits(lookAheadTime, limitsWorkspace,
+                                                                   lookAheadPool.get());
+        }
+        return (*maxContacts)[st];
+    };
+
+    double result = 0;
+
+    /* interactions are grouped by the state of the specie that changes (anchor, e.g. S for transmission).
+     * Contacts of the anchor species are distributed among partners with highest rates first (limit1),
+     * unless the estimation is not better than the number of all possible pairs (limit2).
+     */
+    std::vector<bool> &done = donePairs;
+    done.assign(interactionPairs.size(), false);
+    for (size_t i = 0; i < interactionPairs.size(); i++)
     {
-        result += limit2;
+        if (done[i])
+        {
+            continue;
+        }
+
+        Specie::State anchor = interactionPairs[i].anchor;
+        partners.clear();
+        for (size_t j = i; j < interactionPairs.size(); j++)
+        {
+            if (interactionPairs[j].anchor == anchor)
+            {
+                partners.push_back(&interactionPairs[j]);
+                done[j] = true;
+            }
+        }
+        std::sort(partners.begin(), partners.end(), [](const Model::InteractionPair *a, const Model::InteractionPair *b)
+        {
+            return a->rate > b->rate;
+        });
+
+        double numberOfAnchor = getNumberOfSpecies(anchor);
+
+        //get estimation of the Max. possible contacts based on number of species.
+        double maxContEsteem = 0;
+        double limit2 = 0;
+        for (const Model::InteractionPair *pair: partners)
+        {
+            double numberOfPairs = numberOfAnchor * getNumberOfSpecies(pair->partner);
+            maxContEsteem += numberOfPairs;
+            limit2 += numberOfPairs * pair->rate;
+        }
+
+        double maxContAnchor = std::min(getMaxContacts(anchor), maxContEsteem);
+        double maxContPartners = 0;
+        double limit1 = 0;
+        double remainingContacts = maxContAnchor;
+        for (const Model::InteractionPair *pair: partners)
+        {
+            double maxContPartner = std::min(getMaxContacts(pair->partner),
+                                             numberOfAnchor * getNumberOfSpecies(pair->partner));
+            maxContPartners += maxContPartner;
+
+            double contacts = std::min(maxContPartner, remainingContacts);
+            limit1 += contacts * pair->rate;
+            remainingContacts -= contacts;
+        }
+
+        if (std::min(maxContPartners, maxContAnchor) < maxContEsteem)
+        {
+            result += limit1;
+        }
+        else
+        {
+            result += limit2;
+        }
     }
 
     return result;
 
 }
 
-
-void SSATANX::executeReaction(ContactNetwork & contNetwork, const std::string &reactId, double rStart,
-                          double rBound, double time,
-                          std::vector<std::pair<double, Edge>> &propTransmit,
-                          std::vector<std::pair<double, Node>> &propDiagnos,
-                          std::vector<std::pair<double, Node>> &propDeath)
+void SSATANX::updatePropensity(ContactNetwork & contNetwork, Model::Channel channel)
 {
-
-    if (reactId == "transmission")
-    {
-        auto edgeIterator = std::lower_bound(propTransmit.begin(), propTransmit.end(), rBound - rStart, lambdaLess);
-        contNetwork.executeTransmission(edgeIterator->second, time);
-    }
-    else if (reactId == "diagnosis")
+    Profiler::Timer timer(Profiler::PropensityUpdate);
+    switch (channel)
     {
-        auto nodeIterator = std::lower_bound(propDiagnos.begin(), propDiagnos.end(), rBound - rStart, lambdaLess);
-        contNetwork.executeDiagnosis(nodeIterator->second, time);
+        case Model::Interaction:
+            propensities[channel] = contNetwork.getInteractionPropensity();
+            break;
+        case Model::Transition:
+            propensities[channel] = contNetwork.getTransitionPropensity();
+            break;
+        case Model::Death:
+            propensities[channel] = contNetwork.getDeathPropensity();
+            break;
+        case Model::Birth:
+            propensities[channel] = contNetwork.getBirthRateSum();
+            break;
+        default:
+            break;
     }
+}
 
-    else if (reactId  == "death" )
+void SSATANX::executeReaction(ContactNetwork & contNetwork, Model::Channel channel, double rBound, double time)
+{
+    Profiler::Timer timer(Profiler::ReactionExecution);
+    Profiler::count(Profiler::EpidemicReactions);
+    switch (channel)
     {
-        auto nodeIterator = std::lower_bound(propDeath.begin(), propDeath.end(), rBound - rStart, lambdaLess);
-        contNetwork.executeDeath(nodeIterator->second);
+        case Model::Interaction:
+        {
+            auto [edge, r] = contNetwork.findInteraction(rBound);
+            contNetwork.executeInteraction(edge, r, time);
+            break;
+        }
+        case Model::Transition:
+        {
+            auto [node, r] = contNetwork.findTransition(rBound);
+            contNetwork.executeTransition(node, r, time);
+            break;
+        }
+        case Model::Death:
+        {
+            Node node = contNetwork.findDeath(rBound).first;
+            contNetwork.executeDeath(node);
+            break;
+        }
+        case Model::Birth:
+            contNetwork.executeBirth(time, generator);
+            break;
+        default:
+            break;
     }
 }
-
-
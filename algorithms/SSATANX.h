@@ -5,35 +5,101 @@
 #ifndef ALGO_NSA_H
 #define ALGO_NSA_H
 
+#include <array>
+#include <memory>
 #include <random>
+#include <vector>
+#include "algorithms/AndersonTauLeap.h"
+#include "algorithms/LookAheadPolicy.h"
 #include "contact_network/ContactNetwork.h"
+#include "model/ModelPolicies.h"
 
+class ThreadPool;
 
 class SSATANX
 {
 public:
     SSATANX();
+    explicit SSATANX(std::mt19937_64::result_type seed); //engine with fixed seed, e.g. for replicates of a sweep
+    SSATANX(SSATANX &&) noexcept;
+
+    /*
+     * number of threads evaluating the look-ahead bound, 0 - all hardware threads, 1 (default) - serial.
+     * The bound and thus the simulation do not depend on the number of threads.
+     */
+    void setLookAheadThreads(size_t nThreads);
+
+    void setLookAheadPolicy(const LookAheadPolicy &policy); // default: window until the end of the simulation
+    const LookAheadPolicy &getLookAheadPolicy() const { return lookAheadPolicy; }
+
+    /*
+     * a run [tStart, tEnd] simulated by several calls of execute, e.g. segments of AutoEngine: the policy is started
+     * once for the run and keeps its state between the calls, windows may reach until tEnd of the run.
+     * stopLookAhead() returns to starting the policy for every call.
+     */
+    void continueLookAhead(double tStart, double tEnd);
+    void stopLookAhead();
+
     void execute(double tStart, double tEnd, ContactNetwork &contNetwork,
                  NetworkStorage &nwStorage, size_t &nRejections, size_t &nAcceptance, size_t &nThin);
-    ~SSATANX() {};
+
+    /*
+     * simulation specialised for the model policy (@see ModelPolicies.h),
+     * execute() uses SIDModel for the built-in model and DynamicModel otherwise
+     */
+    template <typename ModelPolicy>
+    void executeModel(double tStart, double tEnd, ContactNetwork &contNetwork,
+                      NetworkStorage &nwStorage, size_t &nRejections, size_t &nAcceptance, size_t &nThin);
+
+    /*
+     * upper limit of the interaction propensity while only contacts change during lookAheadTime,
+     * the part of the look-ahead bound which depends on the network (e.g. for checks of the bound)
+     */
+    double getInteractionUpperLimit(double lookAheadTime, ContactNetwork &contNetwork);
+    ~SSATANX();
 
 private:
 
+    template <typename ModelPolicy>
     double  getPropUpperLimit (double lookAheadTime, ContactNetwork & contNetwork,
-                               double diagnosisUpperLimit, double deathUpperLimit) const;
+                               double transitionUpperLimit, double deathUpperLimit, double birthUpperLimit);
+
+    /*
+     * closed-form upper limit of interactions of the built-in SID model
+     */
+    double  getSIDInteractionLimit (double lookAheadTime, ContactNetwork & contNetwork);
+
+    /*
+     * upper limit of interactions of any model: contacts are distributed among partners greedily by rate
+     */
+    double  getInteractionLimit (double lookAheadTime, ContactNetwork & contNetwork);
 
     double  getPropUpperLimit_naive (ContactNetwork & contNetwork,
-                               double diagnosisUpperLimit, double deathUpperLimit) const;
+                               double transitionUpperLimit, double deathUpperLimit, double birthUpperLimit) const;
+
+    /*
+     * recalculates propensity of the epidemic channel from the counts kept by the network
+     */
+    void updatePropensity(ContactNetwork & contNetwork, Model::Channel channel);
 
-    void executeReaction(ContactNetwork & contNetwork, const std::string &reactId, double rStart,
-                         double rBound, double time,
-                         std::vector<std::pair<double, Edge>> &propTransmit,
-                         std::vector<std::pair<double, Node>> &propDiagnos,
-                         std::vector<std::pair<double, Node>> &propDeath);
+    void executeReaction(ContactNetwork & contNetwork, Model::Channel channel, double rBound, double time);
 
 private:
 
-    static std::mt19937_64 generator;
+    std::mt19937_64 generator;
+
+    std::array<double, Model::NumberOfChannels> propensities {}; //contact channels are handled by tau-leaping, stay 0
+    Anderson::Workspace tauLeapWorkspace; // buffers of tau-leaping reused by all intervals
+    ContactNetwork::LimitsWorkspace limitsWorkspace; // buffers of the look-ahead bound reused by all evaluations
+
+    // buffers of getInteractionLimit: species by state, interaction pairs grouped already, partners of an anchor
+    std::vector<double> numberOfSpecies;
+    std::vector<bool> donePairs;
+    std::vector<const Model::InteractionPair *> partners;
+
+    std::unique_ptr<ThreadPool> lookAheadPool; // nullptr - look-ahead bound is evaluated serially
+    LookAheadPolicy lookAheadPolicy;
+    double lookAheadEnd = -1; // end of a run continued over several calls of execute, < 0 if none
 };
 
 
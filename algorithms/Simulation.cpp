@@ -0,0 +1,100 @@
+//
+// Runs of the algorithms, see Simulation.h
+//
+
+#include <chrono>
+#include <stdexcept>
+#include "Simulation.h"
+#include "algorithms/SSA.h"
+#include "algorithms/SSATANX.h"
+#include "algorithms/AutoEngine.h"
+#include "algorithms/TauLeap.h"
+#include "utilities/Output.h"
+#include "utilities/Profiler.h"
+
+namespace
+{
+    void saveThinningCounters(nlohmann::ordered_json &output, const LookAheadPolicy &policy, size_t nRejections,
+                              size_t nAcceptance, size_t nThin)
+    {
+        output["accepted"] = nAcceptance;
+        output["rejected"] = nRejections;
+        output["thined"] = nThin;
+        saveThinningEfficiency(output, policy, nAcceptance, nThin);
+    }
+}
+
+bool Simulation::isAlgorithm(const std::string &mode)
+{
+    return mode == "-SSA" || mode == "-SSX" || mode == "-AUTO" || mode == "-TAU";
+}
+
+void Simulation::run(const std::string &mode, const Settings &settings, const std::mt19937_64::result_type *seed,
+                     size_t lookAheadThreads, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                     nlohmann::ordered_json &output)
+{
+    if (!isAlgorithm(mode))
+    {
+        std::string msg = "Invalid algorthm specified";
+        throw std::domain_error(msg);
+    }
+
+    Profiler profiler;
+    Profiler::Scope profilerScope(profiler);
+
+    // written after the duration
+    nlohmann::ordered_json counters;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    if (mode == "-SSA")
+    {
+        SSA ssa = seed != nullptr ? SSA(*seed) : SSA();
+        ssa.execute(0, settings.getSimulationTime(), contNetwork, nwStorage);
+    }
+    else if (mode == "-TAU")
+    {
+        size_t nLeaps = 0;
+        size_t nRejections = 0;
+        size_t nSteps = 0;
+        TauLeap tauLeap = seed != nullptr ? TauLeap(*seed) : TauLeap();
+        tauLeap.setEpsilon(settings.getTauLeapEpsilon());
+        tauLeap.execute(0, settings.getSimulationTime(), contNetwork, nwStorage, nLeaps, nRejections, nSteps);
+
+        counters["leaps"] = nLeaps;
+        counters["rejected"] = nRejections;
+        counters["exact_steps"] = nSteps;
+    }
+    else
+    {
+        size_t nRejections = 0;
+        size_t nAcceptance = 0;
+        size_t nThin = 0;
+        if (mode == "-AUTO")
+        {
+            AutoEngine engine = seed != nullptr ? AutoEngine(*seed) : AutoEngine();
+            engine.getSSATANX().setLookAheadThreads(lookAheadThreads);
+            engine.getSSATANX().setLookAheadPolicy(LookAheadPolicy(settings.getLookAheadSettings()));
+            engine.execute(0, settings.getSimulationTime(), contNetwork, nwStorage, nRejections, nAcceptance, nThin);
+            saveThinningCounters(counters, engine.getSSATANX().getLookAheadPolicy(), nRejections, nAcceptance, nThin);
+            saveEngineStatistics(counters, engine);
+        }
+        else
+        {
+            SSATANX ssatanx = seed != nullptr ? SSATANX(*seed) : SSATANX();
+            ssatanx.setLookAheadThreads(lookAheadThreads);
+            ssatanx.setLookAheadPolicy(LookAheadPolicy(settings.getLookAheadSettings()));
+            ssatanx.execute(0, settings.getSimulationTime(), contNetwork, nwStorage, nRejections, nAcceptance, nThin);
+            saveThinningCounters(counters, ssatanx.getLookAheadPolicy(), nRejections, nAcceptance, nThin);
+        }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto time = end_time - start_time;
+
+    output["duration_in_milliseconds"] = std::chrono::duration <double, std::milli> (time).count();
+    for (auto &item: counters.items())
+    {
+        output[item.key()] = item.value();
+    }
+    saveProfile(output, profiler);
+    saveOutput(output, contNetwork, nwStorage);
+}
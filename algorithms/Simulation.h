@@ -0,0 +1,35 @@
+/*
+ * One run of an algorithm selected by its command line flag ("-SSA", "-SSX", "-AUTO" or "-TAU"), shared by single
+ * runs and replicates of parameter sweeps: the engine is set up from the settings, the run is profiled and timed,
+ * and its results are written to the output.
+ */
+
+#ifndef ALGO_SIMULATION_H
+#define ALGO_SIMULATION_H
+
+#include <random>
+#include <string>
+#include "nlohmann/json.h"
+#include "contact_network/ContactNetwork.h"
+#include "utilities/Settings.h"
+#include "utilities/types.h"
+
+class Simulation {
+public:
+    static bool isAlgorithm(const std::string &mode); //@return true if mode is the flag of an algorithm
+
+    /*
+     * simulates [0, simulation time] and writes duration, counters of the algorithm (e.g. accepted proposals of
+     * SSATAN-X), profile, final amounts of species and the stored network states to output
+     * @param seed seed of the engine, nullptr - seeded by time and pid
+     * @param lookAheadThreads number of threads of the look-ahead bound of SSATAN-X, @see SSATANX::setLookAheadThreads
+     */
+    static void run(const std::string &mode, const Settings &settings, const std::mt19937_64::result_type *seed,
+                    size_t lookAheadThreads, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                    nlohmann::ordered_json &output);
+
+private:
+    Simulation(){};
+};
+
+#endif //ALGO_SIMULATION_H
@@ -0,0 +1,355 @@
+//
+// Tau-leaping of contact and epidemic channels, see TauLeap.h
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unistd.h>
+#include "TauLeap.h"
+#include "utilities/Utility.h"
+#include "utilities/Profiler.h"
+
+TauLeap::TauLeap()
+{
+    generator.seed(::time(nullptr) * getpid()); //to change the seed for every run
+}
+
+TauLeap::TauLeap(std::mt19937_64::result_type seed) : generator(seed)
+{
+}
+
+void TauLeap::setEpsilon(double eps)
+{
+    if (!(eps > 0 && eps < 1))
+    {
+        std::string msg = "Invalid epsilon of tau-leaping, it must be in (0, 1)";
+        throw std::domain_error(msg);
+    }
+    epsilon = eps;
+}
+
+void TauLeap::execute(double tStart, double tEnd, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                      size_t &nLeaps, size_t &nRejections, size_t &nSteps)
+{
+    Anderson::startMemory(M, T, C, S, row);
+
+    double time = tStart;
+    nwStorage.emplace_back(time, contNetwork.getNetworkState());
+
+    updatePropensities(contNetwork);
+    double tau = getTau();
+    while (time < tEnd)
+    {
+        double propensitiesSum = std::accumulate(propensities.begin(), propensities.end(), 0.0);
+        if (propensitiesSum == 0)
+        {
+            break;
+        }
+        tau = std::min(tau, tEnd - time);
+
+        if (tau < 10.0 / propensitiesSum)
+        {
+            executeSSA(100, time, tEnd, contNetwork, nwStorage, nSteps);
+            updatePropensities(contNetwork);
+            tau = getTau();
+            continue;
+        }
+
+        Anderson::getChange(M, S, T, C, propensities, row, tau, generator, leapChange);
+        if (isWithinBounds(leapChange, 1))
+        {
+            nLeaps++;
+            Profiler::count(Profiler::LeapsAccepted);
+            acceptLeap(time, tau, contNetwork, nwStorage, leapChange);
+            tau = std::min(updateTau(tau, leapChange), getTau());
+        }
+        else
+        {
+            nRejections++;
+            Profiler::count(Profiler::LeapsRejected);
+            Anderson::rejectLeap(M, tau, S, T, C, propensities, row, leapChange);
+        }
+    }
+
+    if (nwStorage.back().first < tEnd)
+    {
+        nwStorage.emplace_back(tEnd, contNetwork.getNetworkState());
+    }
+}
+
+void TauLeap::updatePropensities(ContactNetwork &contNetwork)
+{
+    Profiler::Timer timer(Profiler::PropensityUpdate);
+    Anderson::getPropensities(contNetwork, contactPropensities, contactX, workspace.propAdd, workspace.propDel);
+
+    propensities[Model::EdgeDeletion] = contactPropensities.at(0);
+    propensities[Model::EdgeAddition] = contactPropensities.at(1);
+    propensities[Model::Interaction] = contNetwork.getInteractionPropensity();
+    propensities[Model::Transition] = contNetwork.getTransitionPropensity();
+    propensities[Model::Death] = contNetwork.getDeathPropensity();
+    propensities[Model::Birth] = contNetwork.getBirthRateSum();
+
+    X[Model::EdgeDeletion] = contactX.at(0);
+    X[Model::EdgeAddition] = contactX.at(1);
+    X[Model::Interaction] = getSmallestInteractingPopulation(contNetwork);
+    X[Model::Transition] = getSmallestPopulation(contNetwork, &Model::getTransitionRate);
+    X[Model::Death] = getSmallestPopulation(contNetwork, &Model::getDeathRate);
+    X[Model::Birth] = contNetwork.size(); // births change the size of the population only
+}
+
+size_t TauLeap::getSmallestPopulation(const ContactNetwork &contNetwork, double (Model::*rate)(Specie::State) const)
+{
+    const Model &model = contNetwork.getModel();
+    size_t result = 0;
+    for (size_t stateId = 0; stateId < model.getNumberOfStates(); stateId++)
+    {
+        Specie::State st = static_cast<Specie::State>(stateId);
+        size_t count = contNetwork.countByState(st);
+        if (count > 0 && (model.*rate)(st) > 0 && (result == 0 || count < result))
+        {
+            result = count;
+        }
+    }
+    return result;
+}
+
+size_t TauLeap::getSmallestInteractingPopulation(const ContactNetwork &contNetwork)
+{
+    size_t result = 0;
+    for (const Model::InteractionPair &pair: contNetwork.getModel().getInteractionPairs())
+    {
+        size_t count = std::min(contNetwork.countByState(pair.anchor), contNetwork.countByState(pair.partner));
+        if (count > 0 && pair.rate > 0 && (result == 0 || count < result))
+        {
+            result = count;
+        }
+    }
+    return result;
+}
+
+double TauLeap::getTau() const
+{
+    double tau = std::numeric_limits<double>::infinity();
+
+    // an edge deletion adds an edge to the complement and vice versa, @see Anderson::getTau
+    double mu = std::abs(propensities[Model::EdgeAddition] - propensities[Model::EdgeDeletion]);
+    double sigmaSquare = propensities[Model::EdgeAddition] + propensities[Model::EdgeDeletion];
+    for (Model::Channel channel: {Model::EdgeDeletion, Model::EdgeAddition})
+    {
+        double bound = std::max(epsilon * X[channel], 1.0);
+        tau = std::min({tau, bound / mu, bound * bound / sigmaSquare});
+    }
+
+    // an epidemic reaction changes its population by one: mean and variance of the change are propensity * tau
+    for (Model::Channel channel: {Model::Interaction, Model::Transition, Model::Death, Model::Birth})
+    {
+        if (propensities[channel] > 0)
+        {
+            tau = std::min(tau, std::max(epsilon * X[channel], 1.0) / propensities[channel]);
+        }
+    }
+    return tau;
+}
+
+double TauLeap::updateTau(double tau, const std::vector<size_t> &change) const
+{
+    if (isWithinBounds(change, 0.75))
+    {
+        return std::pow(tau, tau <= 1 ? Anderson::q1 : Anderson::q2);
+    }
+    return tau * Anderson::p1;
+}
+
+bool TauLeap::isWithinBounds(const std::vector<size_t> &change, double factor) const
+{
+    for (size_t i = 0; i < M; i++)
+    {
+        if (change.at(i) > std::max(factor * epsilon * X.at(i), 1.0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TauLeap::acceptLeap(double &time, double tau, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                         const std::vector<size_t> &change)
+{
+    TraceRecorder::Span span("leap_accept");
+    for (size_t i = 0; i < M; i ++)
+    {
+        T.at(i) += propensities.at(i) * tau;
+        C.at(i) += change.at(i);
+
+        S.at(i).erase(S.at(i).begin(),  S.at(i).begin() + row.at(i) + 1);
+        S.at(i).emplace(S.at(i).begin(), std::make_pair(T.at(i), C.at(i)));
+    }
+    time += tau;
+
+    {
+        Profiler::Timer timer(Profiler::TauLeap);
+        contactChange = {change[Model::EdgeDeletion], change[Model::EdgeAddition]};
+        Anderson::updateNetwork(contactChange, contactOrder, generator, workspace.propAdd, workspace.propDel,
+                                contNetwork);
+    }
+
+    order.clear();
+    for (Model::Channel channel: {Model::Interaction, Model::Transition, Model::Death, Model::Birth})
+    {
+        order.insert(order.end(), change.at(channel), channel);
+    }
+    std::shuffle(order.begin(), order.end(), generator);
+
+    bool executed = false;
+    for (Model::Channel channel: order)
+    {
+        double propensity = 0;
+        switch (channel)
+        {
+            case Model::Interaction:
+                propensity = contNetwork.getInteractionPropensity();
+                break;
+            case Model::Transition:
+                propensity = contNetwork.getTransitionPropensity();
+                break;
+            case Model::Death:
+                propensity = contNetwork.getDeathPropensity();
+                break;
+            default:
+                propensity = contNetwork.getBirthRateSum();
+                break;
+        }
+        if (propensity > 0)
+        {
+            executeReaction(contNetwork, channel, propensity * sampleRandUni(generator), time);
+            executed = true;
+        }
+    }
+
+    if (executed)
+    {
+        nwStorage.emplace_back(time, contNetwork.getNetworkState());
+    }
+    updatePropensities(contNetwork);
+}
+
+void TauLeap::executeSSA(size_t n, double &time, double tEnd, ContactNetwork &contNetwork,
+                         NetworkStorage &nwStorage, size_t &nSteps)
+{
+    TraceRecorder::Span span("ssa_fallback");
+    for (size_t ind = 0; ind < n; ind++)
+    {
+        double propensitiesSum = std::accumulate(propensities.begin(), propensities.end(), 0.0);
+        if (propensitiesSum == 0)
+        {
+            break;
+        }
+
+        double proposedTime = std::log(1 / sampleRandUni(generator)) / propensitiesSum;
+        if (time + proposedTime > tEnd)
+        {
+            time = tEnd;
+            break;
+        }
+        time += proposedTime;
+        nSteps++;
+        Profiler::count(Profiler::SSAFallbackSteps);
+
+        double searchBound = propensitiesSum * sampleRandUni(generator);
+        double pSum = 0;
+        size_t selected = M; // M only if searchBound exceeds the sum by rounding
+        for (size_t i = 0; i < M; i++)
+        {
+            if (propensities[i] > 0 && pSum + propensities[i] >= searchBound)
+            {
+                selected = i;
+                break;
+            }
+            pSum += propensities[i];
+        }
+        if (selected != M)
+        {
+            Model::Channel channel = static_cast<Model::Channel>(selected);
+            executeReaction(contNetwork, channel, searchBound - pSum, time);
+            if (Model::isEpidemic(channel))
+            {
+                nwStorage.emplace_back(time, contNetwork.getNetworkState());
+            }
+        }
+
+        for (size_t i = 0; i < M; i ++)
+        {
+            T.at(i) = T.at(i) + propensities.at(i) * proposedTime;
+            if (i == selected)
+            {
+                C.at(i)++;
+            }
+
+            auto new_end = std::remove_if(S.at(i).begin(), S.at(i).end(),
+                                          [x = std::as_const(T.at(i))](const std::pair<double, size_t> & s)
+                                          { return s.first <= x; });
+            S.at(i).erase(new_end, S.at(i).end());
+            S.at(i).emplace(S.at(i).begin(), std::make_pair(T.at(i), C.at(i)));
+        }
+        updatePropensities(contNetwork);
+    }
+}
+
+void TauLeap::executeReaction(ContactNetwork &contNetwork, Model::Channel channel, double rBound, double time)
+{
+    Profiler::Timer timer(Profiler::ReactionExecution);
+    Profiler::count(Model::isEpidemic(channel) ? Profiler::EpidemicReactions : Profiler::ContactReactions);
+    switch (channel)
+    {
+        case Model::EdgeDeletion:
+        {
+            if (contNetwork.hasHomogeneousContacts())
+            {
+                Edge edge = contNetwork.sampleEdgeDeletion(generator);
+                contNetwork.removeEdge(edge);
+                break;
+            }
+            auto edgeIterator = std::lower_bound(workspace.propDel.begin(), workspace.propDel.end(), rBound,
+                                                 lambdaLess);
+            contNetwork.removeEdge(edgeIterator->second);
+            break;
+        }
+        case Model::EdgeAddition:
+        {
+            if (contNetwork.hasHomogeneousContacts())
+            {
+                Edge edge = contNetwork.sampleEdgeAddition(generator);
+                contNetwork.addEdge(edge);
+                break;
+            }
+            auto edgeIterator = std::lower_bound(workspace.propAdd.begin(), workspace.propAdd.end(), rBound,
+                                                 lambdaLess);
+            contNetwork.addEdge(edgeIterator->second);
+            break;
+        }
+        case Model::Interaction:
+        {
+            auto [edge, r] = contNetwork.findInteraction(rBound);
+            contNetwork.executeInteraction(edge, r, time);
+            break;
+        }
+        case Model::Transition:
+        {
+            auto [node, r] = contNetwork.findTransition(rBound);
+            contNetwork.executeTransition(node, r, time);
+            break;
+        }
+        case Model::Death:
+        {
+            Node node = contNetwork.findDeath(rBound).first;
+            contNetwork.executeDeath(node);
+            break;
+        }
+        case Model::Birth:
+            contNetwork.executeBirth(time, generator);
+            break;
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Approximate simulation by tau-leaping of all channels, for large outbreaks where single epidemic reactions of
+ * SSA and SSATAN-X are the bottleneck.
+ *
+ * Every leap draws Poisson numbers of reactions of each channel for the propensities at its start. Contact channels
+ * are executed as by Anderson::AndersonTauLeap, epidemic reactions one by one on the current network; a reaction
+ * which is not possible any more (e.g. all susceptible species are already infected) is dropped.
+ * Error control per channel: a leap is accepted only if no channel fires more than max(epsilon * X, 1) times,
+ * X - number of edges (complement edges) for contact channels and the smallest population of the states
+ * the propensity of an epidemic channel depends on. Draws of rejected leaps are kept for all channels (Anderson, 2008),
+ * so that rejections do not bias the numbers of reactions. If the leap is shorter than 10 mean times between
+ * reactions, reactions are simulated exactly.
+ */
+
+#ifndef ALGO_TAULEAP_H
+#define ALGO_TAULEAP_H
+
+#include <random>
+#include <vector>
+#include "algorithms/AndersonTauLeap.h"
+#include "contact_network/ContactNetwork.h"
+#include "model/Model.h"
+#include "utilities/types.h"
+
+class TauLeap
+{
+public:
+    TauLeap();
+    explicit TauLeap(std::mt19937_64::result_type seed); //engine with fixed seed, e.g. for replicates of a sweep
+
+    void setEpsilon(double eps); // allowed relative change of a channel per leap, default 0.03
+
+    /*
+     * @param nLeaps, nRejections accepted and rejected leaps
+     * @param nSteps reactions simulated exactly because the leap was too short
+     */
+    void execute(double tStart, double tEnd, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                 size_t &nLeaps, size_t &nRejections, size_t &nSteps);
+
+private:
+
+    /*
+     * propensities of all channels and sizes X of their populations, @see getTau
+     */
+    void updatePropensities(ContactNetwork &contNetwork);
+
+    double getTau() const; //@return leap for which the expected change of every channel is within its bound
+    double updateTau(double tau, const std::vector<size_t> &change) const;
+    bool isWithinBounds(const std::vector<size_t> &change, double factor) const; //change <= max(factor*epsilon*X, 1)
+
+    /*
+     * executes the leap: reactions of contact channels first, as their cumulative rates are valid for the network
+     * at the beginning of the leap, then epidemic reactions in random order
+     */
+    void acceptLeap(double &time, double tau, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                    const std::vector<size_t> &change);
+
+    /*
+     * simulates at most n reactions exactly, keeps times and counts of the channels for the next leaps
+     */
+    void executeSSA(size_t n, double &time, double tEnd, ContactNetwork &contNetwork, NetworkStorage &nwStorage,
+                    size_t &nSteps);
+
+    void executeReaction(ContactNetwork &contNetwork, Model::Channel channel, double rBound, double time);
+
+    /*
+     * smallest number of species of states with rate > 0 (rate of pairs of states for interactions),
+     * 0 if there are none
+     */
+    static size_t getSmallestPopulation(const ContactNetwork &contNetwork, double (Model::*rate)(Specie::State) const);
+    static size_t getSmallestInteractingPopulation(const ContactNetwork &contNetwork);
+
+private:
+    static constexpr size_t M = Model::NumberOfChannels;
+
+    std::mt19937_64 generator;
+    double epsilon = 0.03;
+
+    std::vector<double> propensities = std::vector<double>(M, 0);
+    std::vector<size_t> X = std::vector<size_t>(M, 0);
+    Anderson::Workspace workspace; // cumulative sums of contact rates
+
+    // internal times T and numbers of reactions C of the channels, draws S of rejected leaps, @see Anderson
+    std::vector<double> T;
+    std::vector<size_t> C;
+    std::vector<std::vector<std::pair<double, size_t>>> S;
+    std::vector<size_t> row;
+
+    // buffers of a leap reused by all leaps
+    std::vector<size_t> leapChange;
+    std::vector<double> contactPropensities = std::vector<double>(2, 0);
+    std::vector<size_t> contactX = std::vector<size_t>(2, 0);
+    std::vector<size_t> contactChange = std::vector<size_t>(2, 0);
+    std::vector<size_t> contactOrder;
+    std::vector<Model::Channel> order;
+};
+
+#endif //ALGO_TAULEAP_H
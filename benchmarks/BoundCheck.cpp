@@ -0,0 +1,89 @@
+/*
+ * Regression check of the look-ahead bound of SSATAN-X on heterogeneous populations.
+ *
+ * usage: ssatanx_bound_check [replicates] [window]
+ *
+ * For random networks of 100 susceptible, 100 infected and 800 diagnosed species with heterogeneous contact rates,
+ * the upper limit of the interaction propensity during the window (default 0.02) is compared with the propensity
+ * while only contacts change, tau-leaped in kSteps steps through the window as SSATAN-X does.
+ * Prints the number of checks, violations and the largest ratio of propensity to limit per mean degree
+ * and returns 1 if the propensity exceeded the limit.
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "contact_network/ContactNetwork.h"
+#include "algorithms/AndersonTauLeap.h"
+#include "algorithms/SSATANX.h"
+#include "nlohmann/json.h"
+#include "utilities/Settings.h"
+
+namespace
+{
+    constexpr size_t kSteps = 20;
+    constexpr double kMeanDegrees[] = {2, 8, 32};
+
+    Settings makeSettings(double meanDegree, uint64_t seed)
+    {
+        constexpr size_t nNodes = 1000;
+        nlohmann::json config = {
+            {"species", {{{"state", "S"}, {"amount", 100}, {"death_rate", 0.0}},
+                         {{"state", "I"}, {"amount", 100}, {"death_rate", 0.08}},
+                         {{"state", "D"}, {"amount", 800}, {"death_rate", 0.08}}}},
+            {"initial_edges", static_cast<size_t>(nNodes * meanDegree / 2)},
+            {"diagnosis_rate", 0.5},
+            {"transmission_rate", 0.3},
+            {"new_contact_rate", {0.05, 1.0}},
+            {"loose_contact_rate", {0.2, 2.0}},
+            {"simulation_time", 1.0},
+            {"seed", seed}
+        };
+        Settings settings;
+        settings.parseJson(config);
+        return settings;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t replicates = argc > 1 ? std::stoul(argv[1]) : 20;
+    double window = argc > 2 ? std::stod(argv[2]) : 0.02;
+
+    bool failed = false;
+    std::cout << "mean_degree\tchecks\tviolations\tmax_ratio" << std::endl;
+    for (double meanDegree: kMeanDegrees)
+    {
+        size_t checks = 0;
+        size_t violations = 0;
+        double maxRatio = 0;
+        for (size_t r = 0; r < replicates; r++)
+        {
+            ContactNetwork net(makeSettings(meanDegree, r + 1));
+            SSATANX ssatanx(r + 1);
+            std::mt19937_64 generator(r + 1);
+
+            double limit = ssatanx.getInteractionUpperLimit(window, net);
+            double time = 0;
+            for (size_t step = 1; step <= kSteps; step++)
+            {
+                Anderson::AndersonTauLeap(time, window * static_cast<double>(step) / kSteps, net, generator);
+                double propensity = net.getInteractionPropensity();
+                checks++;
+                if (propensity > limit)
+                {
+                    violations++;
+                }
+                if (limit > 0)
+                {
+                    maxRatio = std::max(maxRatio, propensity / limit);
+                }
+            }
+        }
+        std::cout << meanDegree << "\t" << checks << "\t" << violations << "\t" << maxRatio << std::endl;
+        failed = failed || violations > 0;
+    }
+    return failed ? 1 : 0;
+}
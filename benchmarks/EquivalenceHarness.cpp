@@ -0,0 +1,356 @@
+/*
+ * Statistical equivalence harness of the fast algorithms against the exact SSA.
+ *
+ * usage: ssatanx_equivalence <config.json> [replicates] [alpha] [threads]
+ *
+ * Runs ensembles of all engines of makeEngines() (SSA, SSATAN-X, automatic choice) on the config, replicate r of
+ * every engine starts from the same initial network (seed of the config + r), engines use independent seeds.
+ * Observables of every run:
+ *  final amount of every state, time and height of the peak of infected species ("I", if the model has it),
+ *  mean, variance, median and 90th percentile of the degree and fraction of isolated nodes of the final network,
+ *  number of executed contact reactions (only if profiling is compiled in, @see Profiler.h).
+ * Distributions of the observables of every engine are compared with the reference engine (SSA) by the two-sample
+ * Kolmogorov-Smirnov test; an engine passes if no p-value is below alpha / number of observables (Bonferroni).
+ *
+ * Prints a speed-vs-error report (per observable: means, relative error of the mean, KS statistic, p-value;
+ * per engine: mean wall time, speedup and verdict), writes it to EQUIVALENCE_<timestamp>.txt as json
+ * and returns 1 if any engine fails.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "contact_network/ContactNetwork.h"
+#include "algorithms/AutoEngine.h"
+#include "algorithms/SSA.h"
+#include "algorithms/SSATANX.h"
+#include "nlohmann/json.h"
+#include "utilities/Profiler.h"
+#include "utilities/Settings.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/types.h"
+
+namespace
+{
+    /*
+     * runs the simulation on the network, seed - seed of the engine
+     */
+    using Engine = std::function<void(const Settings &, ContactNetwork &, NetworkStorage &, uint64_t seed)>;
+
+    struct NamedEngine
+    {
+        std::string name;
+        Engine run;
+    };
+
+    /*
+     * engines to compare, the first one is the reference. New engines are added here.
+     */
+    std::vector<NamedEngine> makeEngines()
+    {
+        return {
+            {"SSA", [](const Settings &settings, ContactNetwork &net, NetworkStorage &storage, uint64_t seed)
+            {
+                SSA(seed).execute(0, settings.getSimulationTime(), net, storage);
+            }},
+            {"SSX", [](const Settings &settings, ContactNetwork &net, NetworkStorage &storage, uint64_t seed)
+            {
+                size_t nRejections = 0;
+                size_t nAcceptance = 0;
+                size_t nThin = 0;
+                SSATANX(seed).execute(0, settings.getSimulationTime(), net, storage, nRejections, nAcceptance, nThin);
+            }},
+            {"AUTO", [](const Settings &settings, ContactNetwork &net, NetworkStorage &storage, uint64_t seed)
+            {
+                size_t nRejections = 0;
+                size_t nAcceptance = 0;
+                size_t nThin = 0;
+                AutoEngine(seed).execute(0, settings.getSimulationTime(), net, storage, nRejections, nAcceptance,
+                                         nThin);
+            }}
+        };
+    }
+
+    struct Sample
+    {
+        std::vector<double> observables;
+        double milliseconds;
+    };
+
+    std::vector<std::string> getObservableNames(const Model &model)
+    {
+        std::vector<std::string> names;
+        for (size_t st = 0; st < model.getNumberOfStates(); st++)
+        {
+            names.push_back("final_" + model.getStateName(static_cast<Specie::State>(st)));
+        }
+        names.push_back("peak_time_I");
+        names.push_back("peak_height_I");
+        names.push_back("final_mean_degree");
+        names.push_back("final_degree_variance");
+        names.push_back("final_degree_median");
+        names.push_back("final_degree_p90");
+        names.push_back("final_isolated_fraction");
+        names.push_back("contact_reactions");
+        return names;
+    }
+
+    Sample runReplicate(const Settings &settings, const Engine &engine, uint64_t seed)
+    {
+        ContactNetwork contNetwork(settings);
+        const Model &model = contNetwork.getModel();
+        NetworkStorage nwStorage;
+
+        Profiler profiler;
+        auto start = std::chrono::steady_clock::now();
+        {
+            Profiler::Scope scope(profiler);
+            engine(settings, contNetwork, nwStorage, seed);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        Sample sample;
+        sample.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        for (size_t st = 0; st < model.getNumberOfStates(); st++)
+        {
+            sample.observables.push_back(contNetwork.countByState(static_cast<Specie::State>(st)));
+        }
+
+        // peak of infected species over the stored network states
+        double peakTime = 0;
+        double peakHeight = -1;
+        auto names = getObservableNames(model);
+        bool hasInfected = std::find(names.begin(), names.end(), "final_I") != names.end();
+        if (hasInfected)
+        {
+            Specie::State infected = model.getState("I");
+            for (const auto &item: nwStorage)
+            {
+                double count = std::count_if(item.second.begin(), item.second.end(),
+                                             [&](const specieState &s) { return s.sp.getState() == infected; });
+                if (count > peakHeight)
+                {
+                    peakHeight = count;
+                    peakTime = item.first;
+                }
+            }
+        }
+        sample.observables.push_back(hasInfected ? peakTime : NAN);
+        sample.observables.push_back(hasInfected ? peakHeight : NAN);
+
+        std::vector<specieState> finalState = contNetwork.getNetworkState();
+        std::vector<double> degrees;
+        double sum = 0;
+        double sumSquares = 0;
+        for (const specieState &s: finalState)
+        {
+            degrees.push_back(s.contacts.size());
+            sum += s.contacts.size();
+            sumSquares += static_cast<double>(s.contacts.size()) * s.contacts.size();
+        }
+        double n = std::max<double>(1, finalState.size());
+        sample.observables.push_back(sum / n);
+        sample.observables.push_back(sumSquares / n - (sum / n) * (sum / n));
+
+        std::sort(degrees.begin(), degrees.end());
+        auto quantile = [&degrees](double q)
+        {
+            return degrees.empty() ? 0 : degrees[static_cast<size_t>(q * (degrees.size() - 1))];
+        };
+        sample.observables.push_back(quantile(0.5));
+        sample.observables.push_back(quantile(0.9));
+        sample.observables.push_back(std::count(degrees.begin(), degrees.end(), 0.0) / n);
+
+        sample.observables.push_back(Profiler::enabled ? profiler.getCount(Profiler::ContactReactions) : NAN);
+        return sample;
+    }
+
+    /*
+     * two-sample Kolmogorov-Smirnov statistic, ties are handled by stepping over equal values of both samples
+     */
+    double ksStatistic(std::vector<double> a, std::vector<double> b)
+    {
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        size_t i = 0;
+        size_t j = 0;
+        double d = 0;
+        while (i < a.size() && j < b.size())
+        {
+            double x = std::min(a[i], b[j]);
+            while (i < a.size() && a[i] <= x)
+            {
+                i++;
+            }
+            while (j < b.size() && b[j] <= x)
+            {
+                j++;
+            }
+            d = std::max(d, std::abs(static_cast<double>(i) / a.size() - static_cast<double>(j) / b.size()));
+        }
+        return d;
+    }
+
+    /*
+     * asymptotic p-value of the two-sample KS statistic d for samples of sizes n and m
+     */
+    double ksPValue(double d, size_t n, size_t m)
+    {
+        double ne = static_cast<double>(n) * m / (n + m);
+        double lambda = (std::sqrt(ne) + 0.12 + 0.11 / std::sqrt(ne)) * d;
+        if (lambda < 1e-3)
+        {
+            return 1;
+        }
+        double sum = 0;
+        double sign = 1;
+        for (int k = 1; k <= 100; k++)
+        {
+            double term = sign * std::exp(-2.0 * k * k * lambda * lambda);
+            sum += term;
+            if (std::abs(term) < 1e-12)
+            {
+                break;
+            }
+            sign = -sign;
+        }
+        return std::clamp(2 * sum, 0.0, 1.0);
+    }
+
+    double mean(const std::vector<double> &values)
+    {
+        double sum = 0;
+        for (double v: values)
+        {
+            sum += v;
+        }
+        return values.empty() ? 0 : sum / values.size();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 5)
+    {
+        std::cerr << "usage: " << argv[0] << " <config.json> [replicates] [alpha] [threads]" << std::endl;
+        return 2;
+    }
+    size_t nReplicates = argc > 2 ? std::stoul(argv[2]) : 200;
+    double alpha = argc > 3 ? std::stod(argv[3]) : 0.01;
+    size_t nThreads = argc > 4 ? std::stoul(argv[4]) : 0;
+
+    Settings settings;
+    settings.parseSettings(argv[1]);
+    uint baseSeed = settings.getSeed() == 0 ? 1 : settings.getSeed();
+
+    std::vector<NamedEngine> engines = makeEngines();
+    std::vector<std::string> names = getObservableNames(ContactNetwork(settings).getModel());
+
+    std::vector<std::vector<Sample>> samples(engines.size(), std::vector<Sample>(nReplicates));
+    ThreadPool pool(nThreads);
+    for (size_t e = 0; e < engines.size(); e++)
+    {
+        for (size_t r = 0; r < nReplicates; r++)
+        {
+            pool.submit([&, e, r]()
+            {
+                Settings replicateSettings = settings;
+                replicateSettings.setSeed(baseSeed + r);
+
+                std::seed_seq seq{static_cast<size_t>(baseSeed), e, r};
+                std::vector<std::mt19937_64::result_type> engineSeed(1);
+                seq.generate(engineSeed.begin(), engineSeed.end());
+
+                samples.at(e).at(r) = runReplicate(replicateSettings, engines.at(e).run, engineSeed.at(0));
+            });
+        }
+    }
+    pool.wait();
+
+    auto column = [&](size_t e, size_t o)
+    {
+        std::vector<double> values;
+        for (const Sample &sample: samples.at(e))
+        {
+            values.push_back(sample.observables.at(o));
+        }
+        return values;
+    };
+    auto wallTime = [&](size_t e)
+    {
+        double sum = 0;
+        for (const Sample &sample: samples.at(e))
+        {
+            sum += sample.milliseconds;
+        }
+        return sum / nReplicates;
+    };
+
+    double threshold = alpha / names.size();
+    bool allPassed = true;
+
+    nlohmann::ordered_json output;
+    output["reference"] = engines.at(0).name;
+    output["replicates"] = nReplicates;
+    output["alpha"] = alpha;
+    output["threshold"] = threshold;
+
+    std::cout << std::left << std::setw(8) << "engine" << std::setw(24) << "observable" << std::right
+              << std::setw(14) << "mean_ref" << std::setw(14) << "mean" << std::setw(12) << "rel_error"
+              << std::setw(10) << "ks_d" << std::setw(12) << "p_value" << std::setw(6) << "pass" << std::endl;
+    for (size_t e = 1; e < engines.size(); e++)
+    {
+        bool passed = true;
+        nlohmann::ordered_json engineOutput;
+        for (size_t o = 0; o < names.size(); o++)
+        {
+            std::vector<double> reference = column(0, o);
+            std::vector<double> values = column(e, o);
+            if (std::isnan(mean(reference)))
+            {
+                continue;
+            }
+
+            double d = ksStatistic(reference, values);
+            double p = ksPValue(d, reference.size(), values.size());
+            double meanReference = mean(reference);
+            double meanValues = mean(values);
+            double relError = meanReference == 0 ? std::abs(meanValues) : std::abs(meanValues / meanReference - 1);
+            bool ok = p >= threshold;
+            passed = passed && ok;
+
+            std::cout << std::left << std::setw(8) << engines.at(e).name << std::setw(24) << names.at(o) << std::right
+                      << std::setw(14) << meanReference << std::setw(14) << meanValues << std::setw(12) << relError
+                      << std::setw(10) << d << std::setw(12) << p << std::setw(6) << (ok ? "yes" : "NO") << std::endl;
+
+            engineOutput["observables"][names.at(o)] = {{"mean_reference", meanReference}, {"mean", meanValues},
+                                                        {"relative_error", relError}, {"ks_statistic", d},
+                                                        {"p_value", p}, {"pass", ok}};
+        }
+
+        double speedup = wallTime(0) / wallTime(e);
+        std::cout << engines.at(e).name << ": " << wallTime(e) << " ms/run, reference " << wallTime(0)
+                  << " ms/run, speedup " << speedup << ", " << (passed ? "PASS" : "FAIL") << std::endl;
+
+        engineOutput["milliseconds_per_run"] = wallTime(e);
+        engineOutput["reference_milliseconds_per_run"] = wallTime(0);
+        engineOutput["speedup"] = speedup;
+        engineOutput["pass"] = passed;
+        output["engines"][engines.at(e).name] = engineOutput;
+        allPassed = allPassed && passed;
+    }
+
+    auto const timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+    std::ofstream file("EQUIVALENCE_" + std::to_string(timestamp) + ".txt");
+    file << output << std::endl;
+
+    return allPassed ? 0 : 1;
+}
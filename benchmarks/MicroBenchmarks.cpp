@@ -0,0 +1,408 @@
+/*
+ * Micro-benchmarks of ContactNetwork and tau-leaping kernels.
+ *
+ * usage: ssatanx_bench [filter]
+ *
+ * Every benchmark runs on random networks of all combinations of kNodes and kMeanDegrees
+ * (10% infected, rates as in the example configs, fixed seed) and reports time and heap allocations per operation.
+ * Only benchmarks which names contain filter are run.
+ * Output is a tab-separated table: benchmark, nodes, mean degree, edges, ns/op, allocations/op.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "contact_network/ContactNetwork.h"
+#include "contact_network/ContactEstimation.h"
+#include "algorithms/AndersonTauLeap.h"
+#include "utilities/Settings.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/Utility.h"
+
+namespace
+{
+    std::atomic<size_t> allocations{0};
+}
+
+// count all heap allocations of the benchmarks
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    constexpr std::array<size_t, 3> kNodes {250, 1000, 2000};
+    constexpr std::array<double, 2> kMeanDegrees {4, 16};
+    constexpr double kMinTime = 0.2;      // seconds per benchmark and network
+    constexpr size_t kMaxRounds = 100000;
+    constexpr size_t kMaxRebuildRounds = 10; // rounds of benchmarks that need a new network every round
+
+    /*
+     * time and allocations of the timed sections of one benchmark
+     */
+    class Measurement {
+    public:
+        void start()
+        {
+            startAllocations = allocations.load(std::memory_order_relaxed);
+            startTime = std::chrono::steady_clock::now();
+        }
+
+        void stop(size_t nOperations)
+        {
+            auto end = std::chrono::steady_clock::now();
+            nAllocations += allocations.load(std::memory_order_relaxed) - startAllocations;
+            seconds += std::chrono::duration<double>(end - startTime).count();
+            operations += nOperations;
+        }
+
+        double getSeconds() const { return seconds; }
+        double getNsPerOperation() const { return operations == 0 ? 0 : seconds * 1e9 / operations; }
+        double getAllocationsPerOperation() const
+        {
+            return operations == 0 ? 0 : static_cast<double>(nAllocations) / operations;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point startTime;
+        size_t startAllocations = 0;
+        double seconds = 0;
+        size_t nAllocations = 0;
+        size_t operations = 0;
+    };
+
+    using Round = std::function<void(Measurement &)>;
+
+    struct Benchmark
+    {
+        std::string name;
+        bool rebuild; // true if the benchmark changes the network irreversibly, new network for every round
+        std::function<Round(ContactNetwork &, std::mt19937_64 &)> prepare; // untimed setup, @return timed round
+    };
+
+    Settings makeSettings(size_t nNodes, double meanDegree)
+    {
+        size_t nInfected = std::max<size_t>(1, nNodes / 10);
+        nlohmann::json config = {
+            {"species", {{{"state", "S"}, {"amount", nNodes - nInfected}, {"death_rate", 0.0}},
+                         {{"state", "I"}, {"amount", nInfected}, {"death_rate", 0.08}},
+                         {{"state", "D"}, {"amount", 0}, {"death_rate", 0.08}}}},
+            {"initial_edges", static_cast<size_t>(nNodes * meanDegree / 2)},
+            {"diagnosis_rate", 0.5},
+            {"transmission_rate", 0.004},
+            {"new_contact_rate", {0.5, 2.5}},
+            {"loose_contact_rate", {0.4, 2.0}},
+            {"simulation_time", 1.0},
+            {"seed", 1}
+        };
+        Settings settings;
+        settings.parseJson(config);
+        return settings;
+    }
+
+    /*
+     * @return up to n distinct edges chosen uniformly from the cumulative rate vector (first element is INVALID)
+     */
+    std::vector<Edge> sampleEdges(const std::vector<std::pair<double, Edge>> &edges, size_t n, std::mt19937_64 &generator)
+    {
+        std::vector<size_t> indices(edges.size() - 1);
+        std::iota(indices.begin(), indices.end(), 1);
+        std::shuffle(indices.begin(), indices.end(), generator);
+        indices.resize(std::min(n, indices.size()));
+
+        std::vector<Edge> result;
+        result.reserve(indices.size());
+        for (size_t i: indices)
+        {
+            result.push_back(edges.at(i).second);
+        }
+        return result;
+    }
+
+    std::vector<Benchmark> makeBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+
+        // adds edges of the complement network and removes them again, the network is restored after each round
+        benchmarks.push_back({"addEdge", false, [](ContactNetwork &net, std::mt19937_64 &gen) -> Round
+        {
+            std::vector<std::pair<double, Edge>> rates;
+            net.getEdgeAdditionRateSum(rates);
+            auto edges = std::make_shared<std::vector<Edge>>(sampleEdges(rates, 64, gen));
+            return [&net, edges](Measurement &m)
+            {
+                m.start();
+                for (Edge &e: *edges)
+                {
+                    net.addEdge(e);
+                }
+                m.stop(edges->size());
+                for (Edge &e: *edges)
+                {
+                    net.removeEdge(e);
+                }
+            };
+        }});
+        benchmarks.push_back({"removeEdge", false, [](ContactNetwork &net, std::mt19937_64 &gen) -> Round
+        {
+            std::vector<std::pair<double, Edge>> rates;
+            net.getEdgeDeletionRateSum(rates);
+            auto edges = std::make_shared<std::vector<Edge>>(sampleEdges(rates, 64, gen));
+            return [&net, edges](Measurement &m)
+            {
+                m.start();
+                for (Edge &e: *edges)
+                {
+                    net.removeEdge(e);
+                }
+                m.stop(edges->size());
+                for (Edge &e: *edges)
+                {
+                    net.addEdge(e);
+                }
+            };
+        }});
+        // lookup of edges and complement edges by ids of their nodes
+        benchmarks.push_back({"getEdge", false, [](ContactNetwork &net, std::mt19937_64 &gen) -> Round
+        {
+            auto pairs = std::make_shared<std::vector<std::pair<int, int>>>();
+            std::uniform_int_distribution<int> nodeId(0, static_cast<int>(net.size()) - 1);
+            for (size_t i = 0; i < 1024; i++)
+            {
+                pairs->emplace_back(nodeId(gen), nodeId(gen));
+            }
+            return [&net, pairs](Measurement &m)
+            {
+                size_t found = 0;
+                m.start();
+                for (const auto &[a, b]: *pairs)
+                {
+                    found += net.getEdge(a, b) != ContactGraph::INVALID;
+                    found += net.getComplementEdge(a, b) != ContactGraph::INVALID;
+                }
+                m.stop(2 * pairs->size());
+                volatile size_t sink = found;
+                (void) sink;
+            };
+        }});
+
+        // the buffer is reused by all rounds as by the engines, so only the first round may allocate
+        auto rateSum = []<typename T>(void (ContactNetwork::*getRateSum)(std::vector<std::pair<double, T>> &) const)
+        {
+            return [getRateSum](ContactNetwork &net, std::mt19937_64 &) -> Round
+            {
+                auto buffer = std::make_shared<std::vector<std::pair<double, T>>>();
+                return [&net, getRateSum, buffer](Measurement &m)
+                {
+                    m.start();
+                    (net.*getRateSum)(*buffer);
+                    m.stop(1);
+                };
+            };
+        };
+        benchmarks.push_back({"getEdgeDeletionRateSum", false, rateSum(&ContactNetwork::getEdgeDeletionRateSum)});
+        benchmarks.push_back({"getEdgeAdditionRateSum", false, rateSum(&ContactNetwork::getEdgeAdditionRateSum)});
+        benchmarks.push_back({"getInteractionRateSum", false, rateSum(&ContactNetwork::getInteractionRateSum)});
+        benchmarks.push_back({"getTransitionRateSum", false, rateSum(&ContactNetwork::getTransitionRateSum)});
+        benchmarks.push_back({"getDeathRateSum", false, rateSum(&ContactNetwork::getDeathRateSum)});
+
+        benchmarks.push_back({"getMaxContactsLimitByState", false, [](ContactNetwork &net, std::mt19937_64 &) -> Round
+        {
+            return [&net](Measurement &m)
+            {
+                m.start();
+                for (Specie::State st: {Specie::S, Specie::I, Specie::D})
+                {
+                    volatile double limit = net.getMaxContactsLimitByState(st, 1.0);
+                    (void) limit;
+                }
+                m.stop(3);
+            };
+        }});
+
+        // fused pass of all states, serial and on all hardware threads
+        auto maxContactsLimits = [](size_t nThreads)
+        {
+            return [nThreads](ContactNetwork &net, std::mt19937_64 &) -> Round
+            {
+                std::shared_ptr<ThreadPool> pool = nThreads == 1 ? nullptr : std::make_shared<ThreadPool>(nThreads);
+                auto workspace = std::make_shared<ContactNetwork::LimitsWorkspace>();
+                return [&net, pool, workspace](Measurement &m)
+                {
+                    m.start();
+                    net.getMaxContactsLimits(1.0, *workspace, pool.get());
+                    m.stop(1);
+                };
+            };
+        };
+        benchmarks.push_back({"getMaxContactsLimits", false, maxContactsLimits(1)});
+        benchmarks.push_back({"getMaxContactsLimits_parallel", false, maxContactsLimits(0)});
+        benchmarks.push_back({"getInteractingContactsLimits", false, [](ContactNetwork &net, std::mt19937_64 &) -> Round
+        {
+            auto workspace = std::make_shared<ContactNetwork::LimitsWorkspace>();
+            return [&net, workspace](Measurement &m)
+            {
+                m.start();
+                net.getInteractingContactsLimits(1.0, *workspace);
+                m.stop(1);
+            };
+        }});
+
+        // batched kernel alone on degrees of the network and sampled mean rates, per node
+        benchmarks.push_back({"ContactEstimation::getMaxContacts", false, [](ContactNetwork &net, std::mt19937_64 &gen) -> Round
+        {
+            auto input = std::make_shared<std::array<std::vector<double>, 4>>();
+            std::uniform_real_distribution<double> lambda(0.5 / net.size(), 2.5 / net.size());
+            std::uniform_real_distribution<double> theta(0.4, 2.0);
+            for (const specieState &node: net.getNetworkState())
+            {
+                (*input)[0].push_back(lambda(gen));
+                (*input)[1].push_back(theta(gen));
+                (*input)[2].push_back(static_cast<double>(node.contacts.size()));
+            }
+            (*input)[3].resize(net.size());
+            return [&net, input](Measurement &m)
+            {
+                auto &[meanLambda, meanTheta, contacts, maxContacts] = *input;
+                m.start();
+                ContactEstimation::getMaxContacts(meanLambda.data(), meanTheta.data(), contacts.data(), net.size(),
+                                                  1.0, net.size() - 1.0, maxContacts.data());
+                m.stop(net.size());
+            };
+        }});
+
+        // diagnosis of the infected nodes with the highest degree, cuts all their contacts
+        benchmarks.push_back({"executeTransition", true, [](ContactNetwork &net, std::mt19937_64 &) -> Round
+        {
+            std::vector<size_t> degrees;
+            for (const specieState &node: net.getNetworkState())
+            {
+                degrees.resize(std::max<size_t>(degrees.size(), node.id + 1));
+                degrees.at(node.id) = node.contacts.size();
+            }
+            // nodes with transitions are the infected ones
+            auto infected = std::make_shared<std::vector<std::pair<size_t, Node>>>();
+            std::vector<std::pair<double, Node>> transitions;
+            net.getTransitionRateSum(transitions);
+            for (const auto &node: transitions)
+            {
+                if (node.second != ContactGraph::INVALID)
+                {
+                    infected->emplace_back(degrees.at(ContactGraph::id(node.second)), node.second);
+                }
+            }
+            std::sort(infected->begin(), infected->end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+            infected->resize(std::min<size_t>(infected->size(), 16));
+
+            return [&net, infected](Measurement &m)
+            {
+                double rate = net.getModel().getTransitionRate(Specie::I);
+                m.start();
+                for (auto &node: *infected)
+                {
+                    net.executeTransition(node.second, rate, 0);
+                }
+                m.stop(infected->size());
+            };
+        }});
+
+        benchmarks.push_back({"getNetworkState", false, [](ContactNetwork &net, std::mt19937_64 &) -> Round
+        {
+            return [&net](Measurement &m)
+            {
+                m.start();
+                auto result = net.getNetworkState();
+                m.stop(1);
+            };
+        }});
+
+        // contact dynamics over a time interval of 1 / nodes, i.e. about the same number of contact events
+        benchmarks.push_back({"AndersonTauLeap", false, [](ContactNetwork &net, std::mt19937_64 &gen) -> Round
+        {
+            auto workspace = std::make_shared<Anderson::Workspace>();
+            return [&net, &gen, workspace](Measurement &m)
+            {
+                double tLastNetworkUpdate = 0;
+                m.start();
+                Anderson::AndersonTauLeap(tLastNetworkUpdate, 1.0 / net.size(), net, gen, *workspace);
+                m.stop(1);
+            };
+        }});
+
+        return benchmarks;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    std::cout << "benchmark\tnodes\tmean_degree\tedges\tns_per_op\tallocations_per_op" << std::endl;
+    for (const Benchmark &benchmark: makeBenchmarks())
+    {
+        if (benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for (size_t nNodes: kNodes)
+        {
+            for (double meanDegree: kMeanDegrees)
+            {
+                Settings settings = makeSettings(nNodes, meanDegree);
+                std::mt19937_64 generator(42);
+                Measurement measurement;
+
+                auto net = std::make_unique<ContactNetwork>(settings);
+                size_t nEdges = net->countEdges();
+                Round round = benchmark.prepare(*net, generator);
+                size_t maxRounds = benchmark.rebuild ? kMaxRebuildRounds : kMaxRounds;
+                for (size_t r = 0; r < maxRounds && measurement.getSeconds() < kMinTime; r++)
+                {
+                    if (benchmark.rebuild && r > 0)
+                    {
+                        net = std::make_unique<ContactNetwork>(settings);
+                        round = benchmark.prepare(*net, generator);
+                    }
+                    round(measurement);
+                }
+
+                std::cout << benchmark.name << "\t" << nNodes << "\t" << meanDegree << "\t" << nEdges << "\t"
+                          << measurement.getNsPerOperation() << "\t"
+                          << measurement.getAllocationsPerOperation() << std::endl;
+            }
+        }
+    }
+    return 0;
+}
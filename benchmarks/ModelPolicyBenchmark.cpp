@@ -0,0 +1,114 @@
+/*
+ * Benchmark of the compile-time specialised SID model against the dynamic model path.
+ *
+ * usage: ssatanx_model_bench <config.json> <-SSA|-SSX> [replicates]
+ *
+ * The config must use the built-in model (no "model" field). Every replicate builds the same
+ * initial network (seed of the config + replicate) and runs both paths of the engine with the same engine seed.
+ * Prints mean wall time per run and events per second of both paths and the speedup of SIDModel.
+*/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "contact_network/ContactNetwork.h"
+#include "algorithms/SSA.h"
+#include "algorithms/SSATANX.h"
+#include "model/ModelPolicies.h"
+#include "utilities/Settings.h"
+#include "utilities/types.h"
+
+namespace
+{
+    struct Measurement
+    {
+        double milliseconds = 0;
+        size_t events = 0;
+    };
+
+    template <typename ModelPolicy>
+    void runOnce(const Settings &settings, const std::string &mode, uint seed, Measurement &measurement)
+    {
+        ContactNetwork contNetwork(settings);
+        NetworkStorage nwStorage;
+        nwStorage.reserve(1e6 + 1);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        if (mode == "-SSA")
+        {
+            SSA(seed).executeModel<ModelPolicy>(0, settings.getSimulationTime(), contNetwork, nwStorage);
+        }
+        else
+        {
+            size_t nRejections = 0;
+            size_t nAcceptance = 0;
+            size_t nThin = 0;
+            SSATANX(seed).executeModel<ModelPolicy>(0, settings.getSimulationTime(), contNetwork, nwStorage,
+                                                    nRejections, nAcceptance, nThin);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        measurement.milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+        measurement.events += nwStorage.size();
+    }
+
+    void print(const std::string &name, const Measurement &measurement, size_t replicates)
+    {
+        std::cout << std::left << std::setw(14) << name
+                  << std::right << std::setw(14) << measurement.milliseconds / replicates
+                  << std::setw(16) << measurement.events / (measurement.milliseconds / 1000) << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        std::cerr << "usage: " << argv[0] << " <config.json> <-SSA|-SSX> [replicates]" << std::endl;
+        return 1;
+    }
+
+    std::string mode = argv[2];
+    if (mode != "-SSA" && mode != "-SSX")
+    {
+        std::string msg = "Invalid algorthm specified";
+        throw std::domain_error(msg);
+    }
+    size_t replicates = argc == 4 ? std::stoul(argv[3]) : 10;
+
+    Settings settings;
+    settings.parseSettings(argv[1]);
+    if (settings.hasModel())
+    {
+        std::string msg = "Benchmark of the SID model requires a config without model description";
+        throw std::domain_error(msg);
+    }
+    uint baseSeed = settings.getSeed() == 0 ? 1 : settings.getSeed();
+
+    Measurement sid;
+    Measurement dynamic;
+    for (size_t r = 0; r < replicates; r++)
+    {
+        settings.setSeed(baseSeed + r);
+        // alternate the order to not favour one path by the state of caches
+        if (r % 2 == 0)
+        {
+            runOnce<SIDModel>(settings, mode, baseSeed + r, sid);
+            runOnce<DynamicModel>(settings, mode, baseSeed + r, dynamic);
+        }
+        else
+        {
+            runOnce<DynamicModel>(settings, mode, baseSeed + r, dynamic);
+            runOnce<SIDModel>(settings, mode, baseSeed + r, sid);
+        }
+    }
+
+    std::cout << std::left << std::setw(14) << "policy"
+              << std::right << std::setw(14) << "ms/run" << std::setw(16) << "events/s" << std::endl;
+    print("SIDModel", sid, replicates);
+    print("DynamicModel", dynamic, replicates);
+    std::cout << "speedup " << dynamic.milliseconds / sid.milliseconds << std::endl;
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ * End-to-end scaling benchmark of SSA and SSATAN-X.
+ *
+ * usage: ssatanx_scaling <path to SSATAN-X> [grid.json]
+ *
+ * Generates configs for all combinations of population sizes, mean degrees and contact rate ranges of the grid,
+ * runs the given SSATAN-X executable with -SSA and -SSX on each (fixed seeds, one process per run) and prints
+ * a tab-separated table with mean values over replicates:
+ *  mode, nodes, mean degree, new contact rate [a, b], loose contact rate [a, b],
+ *  wall time, epidemic events/s, contact events/s, peak RSS, speedup of SSX against SSA of the same point.
+ * Event counts are taken from the "profile" section of the output (NaN if profiling is compiled out),
+ * peak RSS from the resource usage of the child process.
+ *
+ * grid.json (all fields optional, defaults in Grid):
+ *  {"nodes": [100, 200], "mean_degree": [2, 8], "contact_rates": [{"new": [0.5, 2.5], "loose": [0.4, 2.0]}],
+ *   "infected_fraction": 0.1, "simulation_time": 5, "replicates": 3, "modes": ["-SSA", "-SSX"]}
+ *
+ * An executable of an older release can be given to catch regressions between releases.
+*/
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "nlohmann/json.h"
+
+namespace
+{
+    struct ContactRates
+    {
+        std::vector<double> newContact;
+        std::vector<double> looseContact;
+    };
+
+    struct Grid
+    {
+        std::vector<size_t> nodes {100, 200, 400};
+        std::vector<double> meanDegrees {2, 8};
+        std::vector<ContactRates> contactRates {{{0.5, 2.5}, {0.4, 2.0}}, {{1.0, 5.0}, {0.8, 4.0}}};
+        double infectedFraction = 0.1;
+        double simulationTime = 5;
+        size_t replicates = 3;
+        std::vector<std::string> modes {"-SSA", "-SSX"};
+    };
+
+    struct Run
+    {
+        double milliseconds = 0;
+        double epidemicEvents = NAN;
+        double contactEvents = NAN;
+        long peakRssKb = 0;
+    };
+
+    Grid readGrid(const std::string &fileName)
+    {
+        Grid grid;
+        std::ifstream file(fileName);
+        if (!file)
+        {
+            std::string msg = "Can not open grid file " + fileName;
+            throw std::domain_error(msg);
+        }
+        nlohmann::json json = nlohmann::json::parse(file);
+
+        grid.nodes = json.value("nodes", grid.nodes);
+        grid.meanDegrees = json.value("mean_degree", grid.meanDegrees);
+        if (json.contains("contact_rates"))
+        {
+            grid.contactRates.clear();
+            for (const auto &rates: json.at("contact_rates"))
+            {
+                grid.contactRates.push_back({rates.at("new").get<std::vector<double>>(),
+                                             rates.at("loose").get<std::vector<double>>()});
+            }
+        }
+        grid.infectedFraction = json.value("infected_fraction", grid.infectedFraction);
+        grid.simulationTime = json.value("simulation_time", grid.simulationTime);
+        grid.replicates = json.value("replicates", grid.replicates);
+        grid.modes = json.value("modes", grid.modes);
+        return grid;
+    }
+
+    nlohmann::json makeConfig(const Grid &grid, size_t nNodes, double meanDegree, const ContactRates &rates,
+                              size_t replicate)
+    {
+        size_t nInfected = std::max<size_t>(1, static_cast<size_t>(nNodes * grid.infectedFraction));
+        return {
+            {"species", {{{"state", "S"}, {"amount", nNodes - nInfected}, {"death_rate", 0.0}},
+                         {{"state", "I"}, {"amount", nInfected}, {"death_rate", 0.08}},
+                         {{"state", "D"}, {"amount", 0}, {"death_rate", 0.08}}}},
+            {"initial_edges", static_cast<size_t>(nNodes * meanDegree / 2)},
+            {"diagnosis_rate", 0.5},
+            {"transmission_rate", 0.004},
+            {"birth_rate", 0.0},
+            {"new_contact_rate", rates.newContact},
+            {"loose_contact_rate", rates.looseContact},
+            {"simulation_time", grid.simulationTime},
+            {"seed", replicate + 1},
+            {"simulation_seed", replicate + 1}
+        };
+    }
+
+    /*
+     * runs executable with config in an empty directory and reads the output it writes there
+     */
+    Run execute(const std::string &executable, const nlohmann::json &config, const std::string &mode)
+    {
+        char dirTemplate[] = "/tmp/ssatanx_scaling_XXXXXX";
+        if (::mkdtemp(dirTemplate) == nullptr)
+        {
+            std::string msg = "Can not create temporary directory";
+            throw std::domain_error(msg);
+        }
+        std::filesystem::path dir(dirTemplate);
+        std::filesystem::path configFile = dir / "config.json";
+        std::ofstream(configFile) << config;
+
+        pid_t pid = ::fork();
+        if (pid < 0)
+        {
+            std::string msg = "Can not start " + executable;
+            throw std::domain_error(msg);
+        }
+        if (pid == 0)
+        {
+            if (::chdir(dir.c_str()) != 0)
+            {
+                ::_exit(127);
+            }
+            ::execl(executable.c_str(), executable.c_str(), configFile.c_str(), mode.c_str(), static_cast<char *>(nullptr));
+            ::_exit(127);
+        }
+
+        int status = 0;
+        struct rusage usage{};
+        ::wait4(pid, &status, 0, &usage);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            std::filesystem::remove_all(dir);
+            std::string msg = "Run of " + executable + " " + mode + " failed";
+            throw std::domain_error(msg);
+        }
+
+        Run run;
+        run.peakRssKb = usage.ru_maxrss;
+        for (const auto &entry: std::filesystem::directory_iterator(dir))
+        {
+            if (entry.path().extension() != ".txt")
+            {
+                continue;
+            }
+            nlohmann::json output = nlohmann::json::parse(std::ifstream(entry.path()));
+            run.milliseconds = output.at("duration_in_milliseconds").get<double>();
+            if (output.contains("profile"))
+            {
+                const auto &counters = output.at("profile").at("counters");
+                run.epidemicEvents = counters.value("epidemic_reactions", NAN);
+                run.contactEvents = counters.value("contact_reactions", NAN);
+            }
+        }
+        std::filesystem::remove_all(dir);
+        return run;
+    }
+
+    std::string range(const std::vector<double> &values)
+    {
+        std::ostringstream result;
+        result << "[" << values.at(0) << "," << values.at(1) << "]";
+        return result.str();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <path to SSATAN-X> [grid.json]" << std::endl;
+        return 1;
+    }
+    std::string executable = std::filesystem::absolute(argv[1]).string();
+    Grid grid = argc == 3 ? readGrid(argv[2]) : Grid();
+
+    std::cout << "mode\tnodes\tmean_degree\tnew_contact_rate\tloose_contact_rate\twall_ms\t"
+                 "epidemic_events_per_s\tcontact_events_per_s\tpeak_rss_kb\tspeedup_vs_SSA" << std::endl;
+    for (size_t nNodes: grid.nodes)
+    {
+        for (double meanDegree: grid.meanDegrees)
+        {
+            for (const ContactRates &rates: grid.contactRates)
+            {
+                std::map<std::string, double> wallTime;
+                for (const std::string &mode: grid.modes)
+                {
+                    Run mean;
+                    double epidemicEvents = 0;
+                    double contactEvents = 0;
+                    for (size_t r = 0; r < grid.replicates; r++)
+                    {
+                        Run run = execute(executable, makeConfig(grid, nNodes, meanDegree, rates, r), mode);
+                        mean.milliseconds += run.milliseconds / grid.replicates;
+                        mean.peakRssKb = std::max(mean.peakRssKb, run.peakRssKb);
+                        epidemicEvents += run.epidemicEvents;
+                        contactEvents += run.contactEvents;
+                    }
+                    wallTime[mode] = mean.milliseconds;
+
+                    double seconds = mean.milliseconds * grid.replicates / 1000;
+                    double speedup = wallTime.count("-SSA") > 0 ? wallTime.at("-SSA") / mean.milliseconds : NAN;
+                    std::cout << mode.substr(1) << "\t" << nNodes << "\t" << meanDegree << "\t"
+                              << range(rates.newContact) << "\t" << range(rates.looseContact) << "\t"
+                              << mean.milliseconds << "\t" << epidemicEvents / seconds << "\t"
+                              << contactEvents / seconds << "\t" << mean.peakRssKb << "\t" << speedup << std::endl;
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+//
+// Batched estimation of the max. number of contacts, see ContactEstimation.h
+//
+// The file is compiled with -ffast-math (see CMakeLists.txt) to use vector exp/log, so no value here
+// may become NaN or infinite: every division, root and logarithm is guarded and invalid lanes are masked.
+//
+
+#include <cmath>
+#include "ContactEstimation.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define CONTACT_ESTIMATION_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define CONTACT_ESTIMATION_CLONES
+#endif
+
+CONTACT_ESTIMATION_CLONES
+void ContactEstimation::getMaxContacts(const double *__restrict meanEdgeAdditionRate,
+                                       const double *__restrict meanEdgeDeletionRate,
+                                       const double *__restrict contacts, size_t n, double t, double Cmax,
+                                       double *__restrict maxContacts)
+{
+#pragma omp simd
+    for (size_t i = 0; i < n; i++)
+    {
+        double C0 = contacts[i];
+        double a = meanEdgeAdditionRate[i] * Cmax;
+        double b = meanEdgeAdditionRate[i] + meanEdgeDeletionRate[i];
+        double bSafe = b > 0 ? b : 1;
+        double aByB = a / bSafe;
+
+        // expectation + 3 sigma at the end of the interval, -1 (ignored) if variance is negative
+        double decay = std::exp(-bSafe * t);
+        double expectation = aByB - (aByB - C0) * decay;
+        double variance = expectation - C0 * decay * decay;
+        double numConEnd = variance >= 0 ? expectation + 3 * std::sqrt(variance >= 0 ? variance : 0) : -1;
+
+        double maxCont = C0 < numConEnd ? numConEnd : C0;
+
+        // extremum of expectation + 3 sigma inside the interval, exists only if contacts decrease (C0 > a/b)
+        double rootVal = std::sqrt(9 * bSafe * bSafe * C0 + (a - bSafe * C0) * (a - bSafe * C0));
+        double denominator = C0 > 0 ? 2 * bSafe * C0 * rootVal : 1;
+        double underLog = ((bSafe * C0 - a) * rootVal + std::abs(a * a - bSafe * C0 * bSafe * C0)) / denominator;
+        double extrema = -std::log(underLog > 0 ? underLog : 1) / bSafe;
+        bool hasExtrema = (a >= 0) & (b > 0) & (C0 > aByB) & (underLog > 0) & (extrema > 0) & (extrema <= t);
+
+        double decayExtrema = std::exp(-bSafe * (hasExtrema ? extrema : 0));
+        double expectationExtrema = aByB - (aByB - C0) * decayExtrema;
+        double varianceExtrema = expectationExtrema - C0 * decayExtrema * decayExtrema;
+        double numConExtrema = hasExtrema & (varianceExtrema >= 0) ?
+                expectationExtrema + 3 * std::sqrt(varianceExtrema >= 0 ? varianceExtrema : 0) : -1;
+
+        maxCont = maxCont < numConExtrema ? numConExtrema : maxCont;
+        maxCont = Cmax < maxCont ? Cmax : maxCont;
+
+        // -1 if the expectation is not defined, otherwise the bounds above are >= 0
+        bool valid = (t > 0) & (b > 0) & (a + C0 > 0);
+        maxContacts[i] = valid ? maxCont : -1;
+    }
+}
+
+CONTACT_ESTIMATION_CLONES
+void ContactEstimation::getContactMoments(const double *__restrict meanEdgeAdditionRate,
+                                          const double *__restrict meanEdgeDeletionRate,
+                                          const double *__restrict contacts, size_t n, double t,
+                                          const double *__restrict Cmax, double *__restrict maxExpectation,
+                                          double *__restrict maxVariance)
+{
+#pragma omp simd
+    for (size_t i = 0; i < n; i++)
+    {
+        double C0 = contacts[i];
+        double a = meanEdgeAdditionRate[i] * Cmax[i];
+        double b = meanEdgeAdditionRate[i] + meanEdgeDeletionRate[i];
+        double bSafe = b > 0 ? b : 1;
+        double aByB = a / bSafe;
+
+        // with d = e^(-b s): expectation aByB + (C0 - aByB) d is monotone in s, so it is max. at one of the ends;
+        // variance aByB + (C0 - aByB) d - C0 d^2 is concave in d, max. at its vertex or at the end of the interval
+        double decay = std::exp(-bSafe * (t > 0 ? t : 0));
+        double expectationEnd = aByB - (aByB - C0) * decay;
+        double expectation = C0 < expectationEnd ? expectationEnd : C0;
+
+        double vertex = C0 > 0 ? (C0 - aByB) / (2 * (C0 > 0 ? C0 : 1)) : decay;
+        double d = vertex < decay ? decay : (vertex > 1 ? 1 : vertex);
+        double variance = aByB + (C0 - aByB) * d - C0 * d * d;
+
+        bool valid = (t > 0) & (b > 0);
+        maxExpectation[i] = valid ? (Cmax[i] < expectation ? Cmax[i] : expectation) : C0;
+        maxVariance[i] = valid & (variance > 0) ? variance : 0;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Batched estimation of the max. number of contacts of nodes during the look-ahead time of SSATAN-X.
+ *
+ * Evaluates the same bound as ContactNetwork::getMaxContactsLimitByState (expectation + 3 sigma at the end of the
+ * interval and at the extremum inside it) for arrays of nodes (structure of arrays), w/o branches and exceptions,
+ * so the loop is vectorised. Nodes with invalid input are masked with -1 in the result instead.
+ *
+ * With GCC on x86-64 the kernel is compiled for AVX-512, AVX2 and the baseline instruction set, the version is
+ * chosen at start-up by the CPU; exp/log are taken from the vector math library of glibc (libmvec).
+ * Results may therefore differ from the scalar bound in the last bits.
+*/
+
+#ifndef ALGO_CONTACTESTIMATION_H
+#define ALGO_CONTACTESTIMATION_H
+
+#include <cstddef>
+
+class ContactEstimation {
+public:
+    /*
+     * @param meanEdgeAdditionRate, meanEdgeDeletionRate, contacts - mean rates and current number of contacts of n nodes
+     * @param t look-ahead time
+     * @param Cmax max. number of contacts of a node
+     * @param maxContacts [out] max. number of contacts of each node during t, at most Cmax;
+     * -1 if the expectation of the node is not defined (e.g. both rates are 0)
+     */
+    static void getMaxContacts(const double *meanEdgeAdditionRate, const double *meanEdgeDeletionRate,
+                               const double *contacts, size_t n, double t, double Cmax, double *maxContacts);
+
+    /*
+     * max. expectation and max. variance of the number of contacts of each node during t (each of them taken over
+     * the interval), e.g. for limits of contacts with a node-specific max. number of contacts.
+     * @param Cmax max. number of contacts of each node, the expectation is at most Cmax
+     * @param maxExpectation, maxVariance [out] of each node; current contacts and 0 if the number of contacts
+     * does not change (both rates are 0)
+     */
+    static void getContactMoments(const double *meanEdgeAdditionRate, const double *meanEdgeDeletionRate,
+                                  const double *contacts, size_t n, double t, const double *Cmax,
+                                  double *maxExpectation, double *maxVariance);
+
+private:
+    ContactEstimation(){};
+};
+
+#endif //ALGO_CONTACTESTIMATION_H
@@ -0,0 +1,221 @@
+//
+// Graph of a contact network, see ContactGraph.h
+//
+
+#include <cmath>
+#include "ContactGraph.h"
+
+void ContactGraph::init(size_t n)
+{
+    neighbors.assign(n, {});
+    alive.assign(n, 1);
+    nodeClass.assign(n, noClass);
+    freeIds.clear();
+    nNodes = n;
+    nEdges = 0;
+    slots.clear();
+    rehash(minSlots);
+}
+
+ContactGraph::Edge ContactGraph::edge(Node a, Node b) const
+{
+    if (a.id == b.id || !valid(a) || !valid(b))
+    {
+        return INVALID;
+    }
+    return Edge(a.id, b.id);
+}
+
+ContactGraph::Edge ContactGraph::pairFromIndex(uint64_t index)
+{
+    auto v = static_cast<uint64_t>((1 + std::sqrt(1 + 8 * static_cast<double>(index))) / 2);
+    while (v * (v - 1) / 2 > index)
+    {
+        v--;
+    }
+    while ((v + 1) * v / 2 <= index)
+    {
+        v++;
+    }
+    return Edge(static_cast<int>(index - v * (v - 1) / 2), static_cast<int>(v));
+}
+
+bool ContactGraph::exists(Edge edge) const
+{
+    return edge.u >= 0 && find(key(edge)) != nullptr;
+}
+
+bool ContactGraph::addEdge(Edge edge)
+{
+    if (!valid(Node(edge.u)) || !valid(Node(edge.v)) || find(key(edge)) != nullptr)
+    {
+        return false;
+    }
+    Slot &slot = insert(key(edge));
+    slot.posInLow = static_cast<uint32_t>(neighbors[edge.u].size());
+    slot.posInHigh = static_cast<uint32_t>(neighbors[edge.v].size());
+    neighbors[edge.u].push_back(edge.v);
+    neighbors[edge.v].push_back(edge.u);
+    nEdges++;
+    return true;
+}
+
+bool ContactGraph::removeEdge(Edge edge)
+{
+    Slot *slot = edge.u >= 0 ? find(key(edge)) : nullptr;
+    if (slot == nullptr)
+    {
+        return false;
+    }
+    uint32_t posInLow = slot->posInLow;
+    uint32_t posInHigh = slot->posInHigh;
+    erase(*slot);
+    removeNeighbor(edge.u, posInLow);
+    removeNeighbor(edge.v, posInHigh);
+    nEdges--;
+
+    // load factor is kept >= 1/8 for randomEdge
+    if (slots.size() > minSlots && 8 * nEdges < slots.size())
+    {
+        rehash(slots.size() / 2);
+    }
+    return true;
+}
+
+void ContactGraph::erase(Node node)
+{
+    while (!neighbors[node.id].empty())
+    {
+        removeEdge(Edge(node.id, neighbors[node.id].back()));
+    }
+    neighbors[node.id].shrink_to_fit();
+    alive[node.id] = 0;
+    nodeClass[node.id] = noClass;
+    freeIds.push_back(node.id);
+    nNodes--;
+}
+
+ContactGraph::Node ContactGraph::addNode()
+{
+    int id;
+    if (!freeIds.empty())
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+        alive[id] = 1;
+    }
+    else
+    {
+        id = static_cast<int>(neighbors.size());
+        neighbors.emplace_back();
+        alive.push_back(1);
+        nodeClass.push_back(noClass);
+    }
+    nNodes++;
+    return Node(id);
+}
+
+void ContactGraph::removeNeighbor(int node, uint32_t pos)
+{
+    std::vector<int> &nodeNeighbors = neighbors[node];
+    int last = nodeNeighbors.back();
+    nodeNeighbors.pop_back();
+    if (pos == nodeNeighbors.size())
+    {
+        return;
+    }
+
+    // the last neighbor moves to pos, its entry in the table follows
+    nodeNeighbors[pos] = last;
+    Slot *slot = find(key(Edge(node, last)));
+    if (node < last)
+    {
+        slot->posInLow = pos;
+    }
+    else
+    {
+        slot->posInHigh = pos;
+    }
+}
+
+const ContactGraph::Slot *ContactGraph::find(uint64_t key) const
+{
+    size_t mask = slots.size() - 1;
+    for (size_t i = home(key); ; i = (i + 1) & mask)
+    {
+        if (slots[i].key == key)
+        {
+            return &slots[i];
+        }
+        if (slots[i].key == emptyKey)
+        {
+            return nullptr;
+        }
+    }
+}
+
+ContactGraph::Slot *ContactGraph::find(uint64_t key)
+{
+    return const_cast<Slot *>(static_cast<const ContactGraph *>(this)->find(key));
+}
+
+ContactGraph::Slot &ContactGraph::insert(uint64_t key)
+{
+    // load factor is kept <= 1/2
+    if (2 * (nEdges + 1) > slots.size())
+    {
+        rehash(2 * slots.size());
+    }
+    size_t mask = slots.size() - 1;
+    size_t i = home(key);
+    while (slots[i].key != emptyKey)
+    {
+        i = (i + 1) & mask;
+    }
+    slots[i].key = key;
+    return slots[i];
+}
+
+void ContactGraph::erase(Slot &slot)
+{
+    // backward shift deletion: entries after the removed one move back if their home position allows it
+    size_t mask = slots.size() - 1;
+    size_t i = &slot - slots.data();
+    for (size_t j = (i + 1) & mask; slots[j].key != emptyKey; j = (j + 1) & mask)
+    {
+        size_t h = home(slots[j].key);
+        bool stays = i <= j ? (i < h && h <= j) : (i < h || h <= j);
+        if (!stays)
+        {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i].key = emptyKey;
+}
+
+void ContactGraph::rehash(size_t capacity)
+{
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(capacity, {emptyKey, 0, 0});
+    shift = 64;
+    for (size_t c = capacity; c > 1; c /= 2)
+    {
+        shift--;
+    }
+
+    size_t mask = capacity - 1;
+    for (const Slot &slot: old)
+    {
+        if (slot.key != emptyKey)
+        {
+            size_t i = home(slot.key);
+            while (slots[i].key != emptyKey)
+            {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+}
@@ -0,0 +1,267 @@
+/*
+ * Simple undirected graph of a contact network.
+ *
+ * Nodes are numbered 0..n-1 when the graph is created. Ids of removed nodes go to a free list and are given to
+ * nodes added later, new ids are appended (vectors grow geometrically), so adding a node is amortised O(1).
+ * Every pair of distinct nodes is an edge: either an existing edge (a contact) or an edge of the complement graph,
+ * the same Edge object identifies the pair in both, as adding/removing an edge only moves it between them.
+ *
+ * Existing edges are stored as flat vectors of neighbours per node. An open-addressing hash table maps the key
+ * of the pair (@see NetworkImport::edgeKey) to the positions of the nodes in the neighbour vectors of each other,
+ * so lookup, addition and removal (swap with the last neighbour) of an edge take constant time.
+ * The table is kept at least 1/8 full, so a uniformly random edge is found by probing random slots.
+ * The complement graph is not stored, its edges are enumerated as pairs of nodes that are not neighbours.
+ *
+ * Nodes have a class (the state of their specie), so edges between nodes of two classes can be enumerated
+ * w/o visiting other edges. DenseContactGraph has the same interface with a bit matrix as adjacency.
+*/
+
+#ifndef ALGO_CONTACTGRAPH_H
+#define ALGO_CONTACTGRAPH_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+class ContactGraph {
+public:
+    struct Invalid {};
+    static constexpr Invalid INVALID {}; // invalid node or edge, e.g. returned if an edge is not found
+    static constexpr unsigned char noClass = 255;
+
+    class Node {
+    public:
+        Node() = default;
+        Node(Invalid) {};
+        bool operator==(const Node &other) const = default;
+        bool operator==(Invalid) const { return id < 0; }
+
+    private:
+        friend ContactGraph;
+        friend class DenseContactGraph;
+        explicit Node(int id) : id(id) {};
+        int id = -1;
+    };
+
+    class Edge {
+    public:
+        Edge() = default;
+        Edge(Invalid) {};
+        bool operator==(const Edge &other) const = default;
+        bool operator==(Invalid) const { return u < 0; }
+
+    private:
+        friend ContactGraph;
+        friend class DenseContactGraph;
+        Edge(int a, int b) : u(a < b ? a : b), v(a < b ? b : a) {};
+        int u = -1; // u < v
+        int v = -1;
+    };
+
+    /*
+     * removes all nodes and edges and creates n nodes w/o edges and class
+     */
+    void init(size_t n);
+
+    size_t countNodes() const { return nNodes; }
+    size_t countEdges() const { return nEdges; }
+    int maxNodeId() const { return static_cast<int>(neighbors.size()) - 1; }
+
+    static int id(Node node) { return node.id; }
+    static Node nodeFromId(int id) { return Node(id); }
+    static Node u(Edge edge) { return Node(edge.u); }
+    static Node v(Edge edge) { return Node(edge.v); }
+    static Node oppositeNode(Node node, Edge edge) { return Node(edge.u == node.id ? edge.v : edge.u); }
+
+    /*
+     * @return edge between nodes a and b (existing or complement), INVALID if a == b or a node was removed
+     */
+    Edge edge(Node a, Node b) const;
+
+    /*
+     * edges of all pairs (u, v), u < v, of the nodes 0..n-1 are numbered by the triangular index v * (v - 1) / 2 + u
+     */
+    static Edge pairFromIndex(uint64_t index);
+    static uint64_t countPairs(size_t n) { return static_cast<uint64_t>(n) * (n - 1) / 2; }
+
+    bool valid(Node node) const { return node.id >= 0 && node.id <= maxNodeId() && alive[node.id]; }
+    bool exists(Edge edge) const; //@return true if edge is an existing edge (contact)
+
+    /*
+     * moves edge from complement to existing edges and back.
+     * @return false if the edge already was existing / complement
+     */
+    bool addEdge(Edge edge);
+    bool removeEdge(Edge edge);
+
+    void erase(Node node); // removes node with all its edges
+
+    Node addNode(); //@return new node w/o edges and class, id of a removed node if there is one
+
+    size_t degree(Node node) const { return neighbors[node.id].size(); }
+
+    void setClass(Node node, unsigned char cls) { nodeClass[node.id] = cls; }
+
+    /*
+     * @return uniformly chosen existing edge, INVALID if there is none. Expected number of probes is at most 8
+     */
+    template <typename Generator>
+    Edge randomEdge(Generator &generator) const
+    {
+        if (nEdges == 0)
+        {
+            return INVALID;
+        }
+        std::uniform_int_distribution<size_t> slotDistribution(0, slots.size() - 1);
+        while (true)
+        {
+            uint64_t slotKey = slots[slotDistribution(generator)].key;
+            if (slotKey != emptyKey)
+            {
+                return Edge(static_cast<int>(slotKey >> 32), static_cast<int>(slotKey & 0xFFFFFFFF));
+            }
+        }
+    }
+
+    /*
+     * calls f(Node) for all neighbours of node, order changes when edges are added or removed
+     */
+    template <typename F>
+    void forEachNeighbor(Node node, F f) const
+    {
+        for (int v: neighbors[node.id])
+        {
+            f(Node(v));
+        }
+    }
+
+    /*
+     * calls f(Node) for all nodes in descending order of ids
+     */
+    template <typename F>
+    void forEachNode(F f) const
+    {
+        for (int id = maxNodeId(); id >= 0; id--)
+        {
+            if (alive[id])
+            {
+                f(Node(id));
+            }
+        }
+    }
+
+    /*
+     * calls f(Edge) for all existing edges
+     */
+    template <typename F>
+    void forEachEdge(F f) const
+    {
+        for (int u = 0; u <= maxNodeId(); u++)
+        {
+            for (int v: neighbors[u])
+            {
+                if (u < v)
+                {
+                    f(Edge(u, v));
+                }
+            }
+        }
+    }
+
+    /*
+     * calls f(Edge) for all existing edges between nodes of classes a and b
+     */
+    template <typename F>
+    void forEachEdgeBetween(unsigned char a, unsigned char b, F f) const
+    {
+        for (int u = 0; u <= maxNodeId(); u++)
+        {
+            if (nodeClass[u] != a)
+            {
+                continue;
+            }
+            for (int v: neighbors[u])
+            {
+                if (nodeClass[v] == b && (a != b || u < v))
+                {
+                    f(Edge(u, v));
+                }
+            }
+        }
+    }
+
+    /*
+     * calls f(Edge) for all edges of the complement graph, O(n^2)
+     */
+    template <typename F>
+    void forEachComplementEdge(F f) const
+    {
+        if (adjacent.size() < neighbors.size())
+        {
+            adjacent.resize(neighbors.size(), 0);
+        }
+        for (int u = 0; u <= maxNodeId(); u++)
+        {
+            if (!alive[u])
+            {
+                continue;
+            }
+            for (int v: neighbors[u])
+            {
+                adjacent[v] = 1;
+            }
+            for (int v = u + 1; v <= maxNodeId(); v++)
+            {
+                if (alive[v] && !adjacent[v])
+                {
+                    f(Edge(u, v));
+                }
+            }
+            for (int v: neighbors[u])
+            {
+                adjacent[v] = 0;
+            }
+        }
+    }
+
+private:
+
+    /*
+     * entry of the hash table: positions of the nodes of an existing edge in the neighbour vectors of each other
+     */
+    struct Slot
+    {
+        uint64_t key;
+        uint32_t posInLow;  // position of the node with the larger id in neighbors of the node with the smaller id
+        uint32_t posInHigh; // and vice versa
+    };
+    static constexpr uint64_t emptyKey = ~uint64_t(0);
+    static constexpr size_t minSlots = 16;
+
+    static uint64_t key(Edge edge) { return (static_cast<uint64_t>(edge.u) << 32) | static_cast<uint32_t>(edge.v); }
+    size_t home(uint64_t key) const { return (key * 0x9E3779B97F4A7C15ull) >> shift; }
+
+    const Slot *find(uint64_t key) const;
+    Slot *find(uint64_t key);
+    Slot &insert(uint64_t key); // key must not be in the table
+    void erase(Slot &slot);
+    void rehash(size_t capacity);
+
+    /*
+     * removes neighbor at pos from neighbors of node, the last neighbor takes its place
+     */
+    void removeNeighbor(int node, uint32_t pos);
+
+    std::vector<std::vector<int>> neighbors;
+    std::vector<unsigned char> alive;
+    std::vector<unsigned char> nodeClass;
+    std::vector<int> freeIds; // ids of removed nodes
+    mutable std::vector<unsigned char> adjacent; // neighbours of a node in forEachComplementEdge, all 0 between calls
+    size_t nNodes = 0;
+    size_t nEdges = 0;
+
+    std::vector<Slot> slots;
+    unsigned shift = 64;
+};
+
+#endif //ALGO_CONTACTGRAPH_H
@@ -2,30 +2,58 @@
 // Created by Malysheva, Nadezhda on 2019-07-28.
 //
 
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
 #include <random>
 #include <unistd.h>
 #include <algorithm>
+#include <numeric>
 #include <stdexcept>
-#include <lemon/full_graph.h>
-#include <lemon/adaptors.h>
+#include <unordered_set>
 
 #include "ContactNetwork.h"
+#include "NetworkImport.h"
+#include "ContactEstimation.h"
+#include "utilities/Profiler.h"
+#include "utilities/ThreadPool.h"
+#include "utilities/Utility.h"
 
-void ContactNetwork::init(const Settings&settings)
+void ContactNetwork::init(const Settings&settings, const ImportedNetwork *initialNetwork)
 {
     std::unordered_map<std::string, SpecieSettings> statesSettings = settings.getStateSettings();
 
-    size_t  nPopulation = statesSettings.at("S").amount +
-            statesSettings.at("D").amount + statesSettings.at("I").amount;
+    ImportedNetwork fileNetwork;
+    if (initialNetwork == nullptr && settings.hasNetworkFile())
+    {
+        NetworkSettings networkSettings = settings.getNetworkSettings();
+        if (!networkSettings.nodeFile.empty())
+        {
+            fileNetwork.nodes = NetworkImport::readNodes(networkSettings.nodeFile, networkSettings.binary);
+        }
+        fileNetwork.edges = NetworkImport::readEdges(networkSettings.edgeFile, networkSettings.binary);
+        initialNetwork = &fileNetwork;
+    }
+
+    // population of an imported network is given by its nodes, otherwise by amounts of species
+    bool importedNodes = initialNetwork != nullptr && !initialNetwork->nodes.empty();
 
-    // init network graph (full graph) and two filters - existing edges and edges to add
-    lemon::FullGraph fullG(nPopulation);
-    lemon::GraphCopy<lemon::FullGraph, lemon::ListGraph> cg(fullG, graph);
-    lemon::FullGraph::EdgeMap<bool> filterFalseEdges(fullG, false);
-    lemon::FullGraph::EdgeMap<bool> filterTrueEdges(fullG, true);
-    cg.edgeMap(filterFalseEdges, filterExistingEdges);
-    cg.edgeMap(filterTrueEdges, filterComplementEdges);
-    cg.run();
+    size_t  nPopulation = 0;
+    for (size_t st = 0; st < model.getNumberOfStates(); st++)
+    {
+        nPopulation += statesSettings.at(model.getStateName(static_cast<Specie::State>(st))).amount;
+    }
+    if (importedNodes)
+    {
+        nPopulation = initialNetwork->nodes.size();
+    }
+
+    // init network graph w/o edges, all node pairs are edges of the complement
+    graph.init(nPopulation);
+    population.resize(graph.maxNodeId() + 1);
+    stateEdges.assign(model.getNumberOfStates() * model.getNumberOfStates(), 0);
+    neighborStates.assign(population.getStates().size() * model.getNumberOfStates(), 0);
 
     std::mt19937_64 generator;
     if (settings.getSeed() == 0)
@@ -37,12 +65,8 @@ void ContactNetwork::init(const Settings&settings)
         generator = std::mt19937_64(settings.getSeed());
     }
 
-    transmissionRate = settings.getTransmissionRate();
-    //birthRate = settings.getBirthRate();
-    diagnosisRate = settings.getDiagnosisRate();
-    deathRate.push_back(statesSettings.at("S").deathRate);
-    deathRate.push_back(statesSettings.at("I").deathRate);
-    deathRate.push_back(statesSettings.at("D").deathRate);
+    birthRate = settings.getBirthRate();
+    birthState = settings.getBirthState().empty() ? static_cast<Specie::State>(0) : model.getState(settings.getBirthState());
 
     /* rates of assemble and disassemble edges are sampled from distributions
      *
@@ -55,50 +79,54 @@ void ContactNetwork::init(const Settings&settings)
 
     size_t maxContacts = nPopulation - 1; //max. num of contacts for each node
 
-    lemon::ListGraph::NodeIt nIt(graph);
-    for (size_t i = 0; i <  statesSettings.at("S").amount; i ++)
+    if (importedNodes)
     {
-        double looseContRate = looseContactDistribution(generator);
-        double newContRate = createContactDistribution(generator);
-
-        Specie::State st = Specie::S;
-        Specie sp = Specie(maxContacts, 0, deathRate.at(st), newContRate, looseContRate, st, 0);
-        population[nIt] = sp;
-        ++nIt;
+        for (size_t i = 0; i < initialNetwork->nodes.size(); i++)
+        {
+            const ImportedNode &node = initialNetwork->nodes[i];
+            if (node.state >= model.getNumberOfStates())
+            {
+                std::string msg = "Imported node has state that is not in the model";
+                throw std::domain_error(msg);
+            }
+            population[graph.nodeFromId(i)] = Specie(maxContacts, 0, model.getDeathRate(node.state), node.newContactRate,
+                                                     node.looseContactRate, node.state,
+                                                     model.getTransitionRate(node.state));
+        }
     }
-
-    for (size_t i = 0; i <  statesSettings.at("I").amount; i ++)
+    else
     {
-        double looseContRate = looseContactDistribution(generator);
-        double newContRate = createContactDistribution(generator);
-
-        Specie::State st = Specie::I;
-        Specie sp = Specie(maxContacts, 0, deathRate.at(st), newContRate, looseContRate, st, diagnosisRate);
-        population[nIt] = sp;
-        ++nIt;
+        initPopulation(statesSettings, maxContacts, generator);
     }
 
-    for (size_t i = 0; i <  statesSettings.at("D").amount; ++i)
-    {
-        double looseContRate = looseContactDistribution(generator);
-        double newContRate = createContactDistribution(generator);
-
-        Specie::State st = Specie::D;
+    graph.forEachNode([this](Node node) { graph.setClass(node, population[node].getState()); });
+    initHomogeneousContacts();
 
-        Specie sp = Specie(maxContacts, 0, deathRate.at(st), newContRate * 0.3, looseContRate, st, 0);
-        population[nIt] = sp;
-        ++nIt;
+    if (initialNetwork != nullptr)
+    {
+        importEdges(initialNetwork->edges);
+        return;
     }
 
-
-    std::vector<int> v(lemon::countEdges(complementEdges));
-    std::iota (std::begin(v), std::end(v), 0);
-    std::shuffle(v.begin(), v.end(), generator);
-
-    for (size_t i = 0; i < settings.getNumberOfEdges(); i ++)
+    // sample distinct node pairs uniformly (Floyd's algorithm) instead of shuffling all pairs
+    uint64_t nPairs = ContactGraph::countPairs(nPopulation);
+    if (settings.getNumberOfEdges() > nPairs)
     {
-        int edgeId = v.at(i);
-        Edge cEdge = complementEdges.edgeFromId(edgeId);
+        std::string msg = "Number of edges exceeds number of node pairs";
+        throw std::domain_error(msg);
+    }
+    std::unordered_set<uint64_t> sampled;
+    sampled.reserve(settings.getNumberOfEdges());
+    for (uint64_t j = nPairs - settings.getNumberOfEdges(); j < nPairs; j++)
+    {
+        uint64_t pair = std::uniform_int_distribution<uint64_t>(0, j)(generator);
+        if (!sampled.insert(pair).second)
+        {
+            pair = j;
+            sampled.insert(pair);
+        }
+
+        Edge cEdge = ContactGraph::pairFromIndex(pair);
         if (getEdgeAdditionRate(cEdge) > 0)
         {
             addEdge(cEdge);
@@ -106,185 +134,254 @@ void ContactNetwork::init(const Settings&settings)
     }
 }
 
-size_t  ContactNetwork::countByState(Specie::State st) const
+void ContactNetwork::initPopulation(const std::unordered_map<std::string, SpecieSettings> &statesSettings,
+                                    size_t maxContacts, std::mt19937_64 &generator)
 {
-    size_t result = 0;
+    int id = graph.maxNodeId(); // species are assigned in order of the nodes
+    for (size_t stateId = 0; stateId < model.getNumberOfStates(); stateId++)
+    {
+        Specie::State st = static_cast<Specie::State>(stateId);
+        for (size_t i = 0; i <  statesSettings.at(model.getStateName(st)).amount; i ++)
+        {
+            double looseContRate = looseContactDistribution(generator);
+            double newContRate = createContactDistribution(generator);
+
+            // species that start in a state with adaptivity, already have reduced rate of new contacts
+            Specie sp = Specie(maxContacts, 0, model.getDeathRate(st), newContRate * model.getNewContactFactor(st),
+                               looseContRate, st, model.getTransitionRate(st));
+            population[graph.nodeFromId(id)] = sp;
+            id--;
+        }
+    }
+}
 
-    for (lemon::ListGraph::NodeIt nIt(graph); nIt != lemon::INVALID; ++nIt)
+void ContactNetwork::importEdges(const std::vector<uint64_t> &edgeKeys)
+{
+    for (uint64_t key: edgeKeys)
     {
-        if (population[nIt].getState() == st)
+        Node nodeU = graph.nodeFromId(static_cast<int>(key >> 32));
+        Node nodeV = graph.nodeFromId(static_cast<int>(key & 0xFFFFFFFF));
+        Edge edge = graph.edge(nodeU, nodeV);
+        if (edge == ContactGraph::INVALID || graph.exists(edge))
         {
-            result++;
+            std::string msg = "Edge list refers to nodes that are not in the population";
+            throw std::domain_error(msg);
         }
+        addEdge(edge);
     }
-    return result;
 }
 
+size_t  ContactNetwork::countByState(Specie::State st) const
+{
+    return population.count(st);
+}
 
-std::vector<std::pair<double, Edge>> ContactNetwork::getTransmissionRateSum() const
+
+void ContactNetwork::getInteractionRateSum(std::vector<std::pair<double, Edge>> &propCumSum) const
 {
-    std::vector<std::pair<double, Edge>> propCumSum;
-    propCumSum.reserve(1e+6);
+    propCumSum.clear();
 
     //element <0, INVALID>
-    std::pair<double, Edge> invalidElem {0, Edge(lemon::INVALID)};
+    std::pair<double, Edge> invalidElem {0, Edge(ContactGraph::INVALID)};
     propCumSum.push_back(invalidElem);
 
-    for (lemon::FilterEdges<lemon::ListGraph>::EdgeIt eIt(existingEdges); eIt != lemon::INVALID; ++eIt)
+    // total rate of interactions of an edge is given by the states of its nodes, only edges between
+    // interacting states are visited
+    for (const Model::InteractionPair &pair: model.getInteractionPairs())
     {
-        double rate = transmissionRates[eIt];
+        double rate = pair.rate;
         if (rate > 0)
         {
-            propCumSum.emplace_back(propCumSum.back().first + rate, eIt);
+            graph.forEachEdgeBetween(pair.anchor, pair.partner, [&](Edge edge)
+            {
+                propCumSum.emplace_back(propCumSum.back().first + rate, edge);
+            });
         }
     }
-    propCumSum.shrink_to_fit();
-    return propCumSum;
-
 }
 
-std::vector<std::pair<double, Node>> ContactNetwork:: getDiagnosisRateSum()const
+void ContactNetwork::getTransitionRateSum(std::vector<std::pair<double, Node>> &propCumSum) const
 {
-    std::vector<std::pair<double, Node>> propCumSum;
-    propCumSum.reserve(1e+6);
+    propCumSum.clear();
 
     //element <0, INVALID>
-    std::pair<double, Node> invalidElem {0, Node (lemon::INVALID)};
+    std::pair<double, Node> invalidElem {0, Node (ContactGraph::INVALID)};
     propCumSum.push_back(invalidElem);
 
-    for (lemon::FilterEdges<lemon::ListGraph>::NodeIt nIt(existingEdges); nIt != lemon::INVALID; ++nIt)
+    // species that died have rate 0
+    const std::vector<double> &rates = population.getDiagnosisRates();
+    for (size_t id = rates.size(); id-- > 0;)
     {
-        double rate = population[nIt].getDiagnosisRate();
+        double rate = rates[id];
         if (rate > 0)
         {
-            propCumSum.emplace_back(propCumSum.back().first + rate, nIt);
+            propCumSum.emplace_back(propCumSum.back().first + rate, graph.nodeFromId(id));
         }
     }
-    propCumSum.shrink_to_fit();
-    return propCumSum;
 }
 
-std::vector<std::pair<double, Edge>> ContactNetwork::getEdgeDeletionRateSum()const
+void ContactNetwork::getEdgeDeletionRateSum(std::vector<std::pair<double, Edge>> &propCumSum) const
 {
-    std::vector<std::pair<double, Edge>> propCumSum;
-    propCumSum.reserve(1e+6);
+    propCumSum.clear();
+    propCumSum.reserve(graph.countEdges() + 1);
 
     //element <0, INVALID>
-    std::pair<double, Edge> invalidElem {0, Edge (lemon::INVALID)};
+    std::pair<double, Edge> invalidElem {0, Edge (ContactGraph::INVALID)};
     propCumSum.push_back(invalidElem);
 
-    for (lemon::FilterEdges<lemon::ListGraph>::EdgeIt eIt(existingEdges); eIt != lemon::INVALID; ++eIt)
+    graph.forEachEdge([&](Edge edge)
     {
-        double rate = getEdgeDeletionRate(eIt);
+        double rate = getEdgeDeletionRate(edge);
         if (rate > 0)
         {
-            propCumSum.emplace_back(propCumSum.back().first + rate, eIt);
+            propCumSum.emplace_back(propCumSum.back().first + rate, edge);
         }
-    }
-    propCumSum.shrink_to_fit();
-    return propCumSum;
-
+    });
 }
 
 
-std::vector<std::pair<double, Edge>> ContactNetwork::getEdgeAdditionRateSum()const
+void ContactNetwork::getEdgeAdditionRateSum(std::vector<std::pair<double, Edge>> &propCumSum) const
 {
-    std::vector<std::pair<double, Edge>> propCumSum;
-    //int popSize = size();
-    //propCumSum.reserve(popSize * (popSize - 1) / 2);
-    propCumSum.reserve(1e+6);
+    propCumSum.clear();
 
     //element <0, INVALID>
-    std::pair<double, Edge> invalidElem {0, Edge (lemon::INVALID)};
+    std::pair<double, Edge> invalidElem {0, Edge (ContactGraph::INVALID)};
     propCumSum.push_back(invalidElem);
 
-    for (lemon::FilterEdges<lemon::ListGraph>::EdgeIt eIt(complementEdges); eIt != lemon::INVALID; ++eIt)
+    graph.forEachComplementEdge([&](Edge edge)
     {
-        double rate = getEdgeAdditionRate(eIt);
+        double rate = getEdgeAdditionRate(edge);
         if (rate > 0)
         {
-            propCumSum.emplace_back(propCumSum.back().first + rate, eIt);
+            propCumSum.emplace_back(propCumSum.back().first + rate, edge);
         }
-    }
-    propCumSum.shrink_to_fit();
-    return propCumSum;
+    });
 }
 
-std::vector<std::pair<double, Node>> ContactNetwork::getDeathRateSum()const
+void ContactNetwork::getDeathRateSum(std::vector<std::pair<double, Node>> &propCumSum) const
 {
-    std::vector<std::pair<double, Node>> propCumSum;
-    //propCumSum.reserve(size());
-    propCumSum.reserve(1e+6);
+    propCumSum.clear();
+    propCumSum.reserve(size() + 1);
 
     //element <0, INVALID>
-    std::pair<double, Node> invalidElem {0, Node(lemon::INVALID)};
+    std::pair<double, Node> invalidElem {0, Node(ContactGraph::INVALID)};
     propCumSum.push_back(invalidElem);
 
-    for(lemon::FilterEdges<lemon::ListGraph>::NodeIt nIt(existingEdges); nIt!=lemon::INVALID; ++nIt)
+    const std::vector<Specie::State> &states = population.getStates();
+    const std::vector<double> &rates = population.getDeathRates();
+    for (size_t id = states.size(); id-- > 0;)
     {
-        double rate = population[nIt].getDeathRate();
+        if (states[id] != SpecieStore::noSpecie)
+        {
+            propCumSum.emplace_back(propCumSum.back().first + rates[id], graph.nodeFromId(id));
+        }
+    }
+}
+
+double ContactNetwork::getDeathPropensity() const
+{
+    return getStatePropensity(&Model::getDeathRate);
+}
 
-        propCumSum.emplace_back(propCumSum.back().first + rate, nIt);
+double ContactNetwork::getTransitionPropensity() const
+{
+    return getStatePropensity(&Model::getTransitionRate);
+}
+
+std::pair<Node, double> ContactNetwork::findDeath(double r) const
+{
+    return findByState(r, &Model::getDeathRate);
+}
+
+std::pair<Node, double> ContactNetwork::findTransition(double r) const
+{
+    return findByState(r, &Model::getTransitionRate);
+}
+
+double ContactNetwork::getStatePropensity(double (Model::*rate)(Specie::State) const) const
+{
+    double result = 0;
+    for (size_t stateId = 0; stateId < model.getNumberOfStates(); stateId++)
+    {
+        Specie::State st = static_cast<Specie::State>(stateId);
+        result += countByState(st) * (model.*rate)(st);
     }
+    return result;
+}
 
-    propCumSum.shrink_to_fit();
-    return propCumSum;
+std::pair<Node, double> ContactNetwork::findByState(double r, double (Model::*rate)(Specie::State) const) const
+{
+    Specie::State found = SpecieStore::noSpecie;
+    for (size_t stateId = 0; stateId < model.getNumberOfStates(); stateId++)
+    {
+        Specie::State st = static_cast<Specie::State>(stateId);
+        double stateRate = (model.*rate)(st);
+        if (countByState(st) == 0 || stateRate <= 0)
+        {
+            continue;
+        }
+        found = st;
+        double statePropensity = countByState(st) * stateRate;
+        if (r <= statePropensity)
+        {
+            break;
+        }
+        r -= statePropensity; // r can exceed the propensity due to rounding, the last state is taken then
+    }
+    if (found == SpecieStore::noSpecie)
+    {
+        std::string msg = "ERROR: no specie with rate > 0";
+        throw std::domain_error(msg);
+    }
 
+    const std::vector<uint32_t> &members = population.getMembers(found);
+    double stateRate = (model.*rate)(found);
+    double position = std::clamp(std::ceil(r / stateRate) - 1, 0.0, static_cast<double>(members.size() - 1));
+    size_t index = static_cast<size_t>(position);
+    double rest = std::clamp(r - index * stateRate, std::numeric_limits<double>::min(), stateRate);
+    return {graph.nodeFromId(static_cast<int>(members[index])), rest};
 }
 
-double ContactNetwork::getTransmissionRateLimit() const
+const Model & ContactNetwork::getModel() const
 {
-    return transmissionRate;
+    return model;
 }
 
 
-/*double ContactNetwork::getBirthRateSum()const
+double ContactNetwork::getBirthRateSum()const
 {
     return birthRate;
-}*/
+}
 
 size_t ContactNetwork::size() const
 {
-    return lemon::countNodes(existingEdges);
+    return graph.countNodes();
 }
 
 std::pair<int, int> ContactNetwork::addEdge(Edge &complementEdge)
 {
 
+    if (!graph.addEdge(complementEdge))
+    {
+        std::string msg = "ERROR: INVALID EDGE TO ADD!";
+        throw std::domain_error(msg);
+    }
     //nodes of the given edge in a complement graph
     Node nodeU = graph.u(complementEdge);
     Node nodeV = graph.v(complementEdge);
-    filterExistingEdges[complementEdge] = true;
-    filterComplementEdges[complementEdge] = false;
 
     std::pair<int, int> result = std::make_pair(graph.id(nodeU), graph.id(nodeV));
 
     //for these nodes increase number of contacts
     population[nodeU].incNumberOfContacts();
     population[nodeV].incNumberOfContacts();
-
-    //calculate transmission rate
-    double trRate = 0;
-    if ((population[nodeU].getState()  == Specie::S  && population[nodeV].getState() == Specie::I) ||
-        (population[nodeU].getState()  == Specie::I  && population[nodeV].getState() == Specie::S))
-    {
-        trRate = transmissionRate;
-    }
-
-    if ((population[nodeU].getState()  == Specie::S  && population[nodeV].getState() == Specie::D) ||
-        (population[nodeU].getState()  == Specie::D  && population[nodeV].getState() == Specie::S))
-    {
-        //for edges Diagnosed "D"- Susceptible "S" transmission rate is 50% lower than for edges "I" - "S"
-        trRate = transmissionRate * 0.5;
-    }
-
-    transmissionRates[complementEdge] = trRate;
+    countStateEdge(nodeU, nodeV, 1);
     return result;
 }
 
 std::pair<int, int> ContactNetwork::removeEdge(Edge &edge)
 {
-    if (!graph.valid(edge))
+    if (!graph.removeEdge(edge))
     {
         std::string msg = "ERROR: INVALID EDGE TO DEL!";
         throw std::domain_error(msg);
@@ -295,14 +392,10 @@ std::pair<int, int> ContactNetwork::removeEdge(Edge &edge)
 
     std::pair<int, int> result = std::make_pair(graph.id(nodeU), graph.id(nodeV));
 
-    transmissionRates[edge] = 0;
-
-    filterExistingEdges[edge] = false;
-    filterComplementEdges[edge] = true;
-
     // after removing an edge decrease num. of actual contacts for each of the incident nodes
     population[nodeU].decNumberOfContacts();
     population[nodeV].decNumberOfContacts();
+    countStateEdge(nodeU, nodeV, -1);
 
     return result;
 
@@ -311,98 +404,318 @@ std::pair<int, int> ContactNetwork::removeEdge(Edge &edge)
 void ContactNetwork::removeNode(Node &node)
 {
     //delete all edges to given node in network
-    lemon::ListGraph::IncEdgeIt ieIt(graph, node);
+    graph.forEachNeighbor(node, [this, &node](Node neighbor)
+    {
+        population[neighbor].decNumberOfContacts();
+        countStateEdge(node, neighbor, -1);
+    });
 
-    while (ieIt != lemon::INVALID)
+    population.remove(node);
+    graph.erase(node);
+}
+
+void ContactNetwork::executeInteraction(Edge & edge, double r, double time)
+{
+    Node nodeU = graph.u(edge);
+    Node nodeV = graph.v(edge);
+
+    const Model::EdgeReaction &edgeReaction = model.selectInteraction(population[nodeU].getState(),
+                                                                      population[nodeV].getState(), r);
+    const Model::Reaction &reaction = model.getReactions()[edgeReaction.reaction];
+
+    Node first = edgeReaction.swapped ? nodeV : nodeU;
+    Node second = edgeReaction.swapped ? nodeU : nodeV;
+
+    if (reaction.to != reaction.from)
     {
-        lemon::ListGraph::IncEdgeIt tmpIt = ieIt;
-        Node oppositeNode = graph.oppositeNode(node, ieIt);
+        changeState(first, reaction.to, time);
+    }
+    if (reaction.partnerTo != reaction.partnerFrom)
+    {
+        changeState(second, reaction.partnerTo, time);
+    }
+}
 
-        population[oppositeNode].decNumberOfContacts();
-        ++ieIt;
-        graph.erase(tmpIt);
+void ContactNetwork::executeTransition(Node & node, double r, double time)
+{
+    const Model::Reaction &reaction = model.selectTransition(population[node].getState(), r);
+    changeState(node, reaction.to, time);
+}
 
+void ContactNetwork::changeState(Node node, Specie::State st, double time)
+{
+    // edges of the node move to the new state, O(degree)
+    graph.forEachNeighbor(node, [this, node](Node neighbor) { countStateEdge(node, neighbor, -1); });
+    population[node].changeState(st, time);
+    graph.setClass(node, st);
+    graph.forEachNeighbor(node, [this, node](Node neighbor) { countStateEdge(node, neighbor, 1); });
+    population[node].setDeathRate(model.getDeathRate(st));
+    population[node].setDiagnosisRate(model.getTransitionRate(st));
+
+    if (model.isCuttingContacts(st))
+    {
+        //adaptivity: cut all contacts
+        cutNeighbors.clear();
+        graph.forEachNeighbor(node, [this](Node neighbor) { cutNeighbors.push_back(neighbor); });
+        for (Node neighbor: cutNeighbors)
+        {
+            Edge edge = graph.edge(node, neighbor);
+            removeEdge(edge);
+        }
     }
 
-    graph.erase(node);
+    //adaptivity: change rate of establishing new contacts
+    if (model.getNewContactFactor(st) != 1)
+    {
+        population[node].setNewContactRate(population[node].getNewContactRate() * model.getNewContactFactor(st));
+    }
+    checkHomogeneousContacts(node);
 }
 
-void ContactNetwork::executeTransmission(Edge & edge, double time)
+void ContactNetwork::executeDeath(Node & node)
 {
-    Node nodeU = graph.u(edge);
-    Node nodeV = graph.v(edge);
+    // max. number of contacts of the other species follows from the size of the population
+    removeNode(node);
 
-    Node infectedNode;
+}
+
+void ContactNetwork::executeBirth(double time, std::mt19937_64 &generator)
+{
+    Node node = graph.addNode();
+    population.resize(graph.maxNodeId() + 1);
+    neighborStates.resize(population.getStates().size() * model.getNumberOfStates(), 0);
+
+    double looseContRate = looseContactDistribution(generator);
+    double newContRate = createContactDistribution(generator);
+    Specie sp = Specie(size() - 1, 0, model.getDeathRate(birthState), newContRate * model.getNewContactFactor(birthState),
+                       looseContRate, birthState, model.getTransitionRate(birthState));
+    sp.changeState(birthState, time);
+    population[node] = sp;
+    graph.setClass(node, birthState);
+    checkHomogeneousContacts(node);
+}
 
-    if (population[nodeU].getState()  == Specie::S)
+void ContactNetwork::initHomogeneousContacts()
+{
+    stateNewContactRate.assign(model.getNumberOfStates(), -1);
+    homogeneousContacts = true;
+    bool first = true;
+    graph.forEachNode([this, &first](Node node)
+    {
+        if (first)
+        {
+            homogeneousLooseContactRate = population[node].getLooseContactRate();
+            first = false;
+        }
+        checkHomogeneousContacts(node);
+    });
+}
+
+void ContactNetwork::checkHomogeneousContacts(Node node)
+{
+    if (!homogeneousContacts)
+    {
+        return;
+    }
+    double &newContactRate = stateNewContactRate[population[node].getState()];
+    if (newContactRate < 0)
+    {
+        newContactRate = population[node].getNewContactRate();
+    }
+    if (newContactRate != population[node].getNewContactRate() ||
+        homogeneousLooseContactRate != population[node].getLooseContactRate())
+    {
+        homogeneousContacts = false;
+    }
+}
+
+void ContactNetwork::countStateEdge(Node u, Node v, int delta)
+{
+    size_t nStates = model.getNumberOfStates();
+    Specie::State a = population[u].getState();
+    Specie::State b = population[v].getState();
+    stateEdges[a * nStates + b] += delta;
+    if (a != b)
     {
-        population[nodeU].changeState(Specie::I, time);
-        population[nodeU].setDeathRate(deathRate.at(Specie::I));
-        infectedNode = nodeU;
+        stateEdges[b * nStates + a] += delta;
     }
+    neighborStates[graph.id(u) * nStates + b] += delta;
+    neighborStates[graph.id(v) * nStates + a] += delta;
+}
 
-    else if (population[nodeV].getState()  == Specie::S)
+double ContactNetwork::getInteractionPropensity() const
+{
+    size_t nStates = model.getNumberOfStates();
+    double result = 0;
+    for (const Model::InteractionPair &pair: model.getInteractionPairs())
     {
-        population[nodeV].changeState(Specie::I, time);
-        population[nodeV].setDeathRate(deathRate.at(Specie::I));
-        infectedNode = nodeV;
+        result += pair.rate * stateEdges[pair.anchor * nStates + pair.partner];
     }
+    return result;
+}
 
-    population[infectedNode].setDiagnosisRate(diagnosisRate);
-    for(lemon::FilterEdges<lemon::ListGraph>::IncEdgeIt ieIt(existingEdges, infectedNode); ieIt!=lemon::INVALID; ++ieIt)
+std::pair<Edge, double> ContactNetwork::findInteraction(double r) const
+{
+    size_t nStates = model.getNumberOfStates();
+    const Model::InteractionPair *found = nullptr;
+    for (const Model::InteractionPair &pair: model.getInteractionPairs())
     {
-        transmissionRates[ieIt] = 0;
-        Node neighbourNode = existingEdges.oppositeNode(infectedNode, ieIt);
-        if(population[neighbourNode].getState() == Specie::S)
+        double pairPropensity = pair.rate * stateEdges[pair.anchor * nStates + pair.partner];
+        if (pairPropensity <= 0)
+        {
+            continue;
+        }
+        found = &pair;
+        if (r <= pairPropensity)
         {
-            transmissionRates[ieIt] = transmissionRate;//transmitDistribution(generator);
+            break;
+        }
+        r -= pairPropensity; // r can exceed the propensity due to rounding, the last pair is taken then
+    }
+    if (found == nullptr)
+    {
+        std::string msg = "ERROR: no edge with interaction rate > 0";
+        throw std::domain_error(msg);
+    }
 
+    // edges of the pair are visited from both ends if both nodes are in the same state, each edge has
+    // multiplicity such ends (half-edges) which are numbered through the members of the anchor state
+    size_t multiplicity = found->anchor == found->partner ? 2 : 1;
+    size_t halfEdges = multiplicity * stateEdges[found->anchor * nStates + found->partner];
+    double position = multiplicity * r / found->rate;
+    auto halfEdge = static_cast<size_t>(std::clamp(std::ceil(position) - 1, 0.0, static_cast<double>(halfEdges - 1)));
+    double rest = std::clamp((position - halfEdge) * found->rate, std::numeric_limits<double>::min(), found->rate);
+
+    for (uint32_t id: population.getMembers(found->anchor))
+    {
+        size_t partners = neighborStates[id * nStates + found->partner];
+        if (halfEdge >= partners)
+        {
+            halfEdge -= partners;
+            continue;
         }
+        Node anchor = graph.nodeFromId(static_cast<int>(id));
+        Node partner = ContactGraph::INVALID;
+        graph.forEachNeighbor(anchor, [&](Node neighbor)
+        {
+            if (partner == ContactGraph::INVALID && population[neighbor].getState() == found->partner)
+            {
+                if (halfEdge == 0)
+                {
+                    partner = neighbor;
+                }
+                halfEdge--;
+            }
+        });
+        return {graph.edge(anchor, partner), rest};
     }
+    std::string msg = "ERROR: interaction not found";
+    throw std::domain_error(msg);
+}
 
+size_t ContactNetwork::countStatePairs(Specie::State a, Specie::State b) const
+{
+    size_t nA = countByState(a);
+    return a == b ? nA * (nA - 1) / 2 : nA * countByState(b);
 }
 
-void ContactNetwork::executeDiagnosis(Node & node, double time)
+bool ContactNetwork::hasHomogeneousContacts() const
 {
-    population[node].changeState(Specie::D, time);
+    return homogeneousContacts;
+}
 
-    population[node].setDiagnosisRate(0); //diagnosed can't be diagnosed anymore
+double ContactNetwork::getEdgeDeletionPropensity() const
+{
+    return homogeneousLooseContactRate * homogeneousLooseContactRate * countEdges();
+}
 
-    //adaptivity: as soon as diagnosed, cut all contacts and reduce
-    //new contact rate to 30%
-    lemon::FilterEdges<lemon::ListGraph>::IncEdgeIt ieIt(existingEdges, node);
-    while (ieIt != lemon::INVALID)
+double ContactNetwork::getEdgeAdditionPropensity() const
+{
+    size_t nStates = model.getNumberOfStates();
+    double result = 0;
+    for (size_t a = 0; a < nStates; a++)
     {
-        lemon::FilterEdges<lemon::ListGraph>::IncEdgeIt tmpIt(ieIt);
-        ++ieIt;
-        removeEdge(tmpIt);
+        for (size_t b = a; b < nStates; b++)
+        {
+            size_t pairs = countStatePairs(static_cast<Specie::State>(a), static_cast<Specie::State>(b));
+            if (pairs > 0)
+            {
+                result += stateNewContactRate[a] * stateNewContactRate[b] * (pairs - stateEdges[a * nStates + b]);
+            }
+        }
     }
-
-    population[node].setDeathRate(deathRate.at(Specie::D));
-    population[node].setNewContactRate(
-            population[node].getNewContactRate() * 0.3);
+    return result;
 }
 
-void ContactNetwork::executeDeath(Node & node)
+size_t ContactNetwork::countDeletableEdges() const
 {
-    removeNode(node);
+    return homogeneousLooseContactRate > 0 ? countEdges() : 0;
+}
 
-    // after removing node from the population decrease max. number of contacts for each specie.
-    for (lemon::ListGraph::NodeIt nIt(graph); nIt != lemon::INVALID; ++nIt)
+size_t ContactNetwork::countAddableEdges() const
+{
+    size_t nStates = model.getNumberOfStates();
+    size_t result = 0;
+    for (size_t a = 0; a < nStates; a++)
     {
-        population[nIt].setMaxNumberOfContacts(population[nIt].getMaxNumberOfContacts() - 1);
+        for (size_t b = a; b < nStates; b++)
+        {
+            size_t pairs = countStatePairs(static_cast<Specie::State>(a), static_cast<Specie::State>(b));
+            if (pairs > 0 && stateNewContactRate[a] * stateNewContactRate[b] > 0)
+            {
+                result += pairs - stateEdges[a * nStates + b];
+            }
+        }
     }
+    return result;
+}
 
+Edge ContactNetwork::sampleEdgeDeletion(std::mt19937_64 &generator) const
+{
+    return graph.randomEdge(generator);
 }
 
-/*void ContactNetwork::executeBirth(double rStart, double rBound)
+Edge ContactNetwork::sampleEdgeAddition(std::mt19937_64 &generator) const
 {
-    double result = rStart;
-    result += birthRate;
-    if (result >= rBound)
+    double maxRate = 0;
+    for (size_t st = 0; st < model.getNumberOfStates(); st++)
+    {
+        if (countByState(static_cast<Specie::State>(st)) > 0)
+        {
+            maxRate = std::max(maxRate, stateNewContactRate[st]);
+        }
+    }
+
+    // a pair of ids is accepted with prob. of its rate / maxRate^2, expected number of trials is
+    // (maxRate * number of ids)^2 / (2 * propensity). If it is large, e.g. in an almost complete graph, the edge is
+    // chosen from the cumulative sums instead
+    double propensity = getEdgeAdditionPropensity();
+    double nIds = graph.maxNodeId() + 1;
+    if (maxRate * maxRate * nIds * nIds > 2 * maxTrialsPerAddition * propensity)
     {
+        getEdgeAdditionRateSum(additionRates);
+        auto edgeIterator = std::lower_bound(additionRates.begin(), additionRates.end(),
+                                             additionRates.back().first * sampleRandUni(generator), lambdaLess);
+        return edgeIterator->second;
     }
-}*/
+
+    std::uniform_int_distribution<int> idDistribution(0, graph.maxNodeId());
+    while (true)
+    {
+        Node nodeU = graph.nodeFromId(idDistribution(generator));
+        Node nodeV = graph.nodeFromId(idDistribution(generator));
+        Edge edge = graph.edge(nodeU, nodeV);
+        if (edge == ContactGraph::INVALID || graph.exists(edge))
+        {
+            continue;
+        }
+        double rate = population[nodeU].getNewContactRate() * population[nodeV].getNewContactRate();
+        if (rate >= maxRate * maxRate * sampleRandUni(generator))
+        {
+            return edge;
+        }
+    }
+}
 
 double  ContactNetwork::getEdgeAdditionRate(const Edge &complementEdge) const
 {
@@ -433,33 +746,23 @@ double  ContactNetwork::getEdgeDeletionRate(const Edge &networkEdge) const
 
 size_t  ContactNetwork::countEdges() const
 {
-    return lemon::countEdges(existingEdges);}
+    return graph.countEdges();}
 
 
 std::vector<specieState> ContactNetwork::getNetworkState() const
 {
+    Profiler::Timer timer(Profiler::Snapshot);
     std::vector<specieState> result;
-    //result.reserve(this->size()); //reserving space for vector.
-    result.reserve(1e+6);
-    for(lemon::FilterEdges<lemon::ListGraph>::NodeIt nIt(existingEdges); nIt!=lemon::INVALID; ++nIt)
+    result.reserve(size());
+    graph.forEachNode([&](Node node)
     {
-        std::vector<int> neighbors;
-        neighbors.reserve(1e+6);
-
-        for(lemon::FilterEdges<lemon::ListGraph>::IncEdgeIt e(existingEdges, nIt); e!=lemon::INVALID; ++e)
-        {
-            Node neighbor = existingEdges.oppositeNode(nIt, e);
-            neighbors.push_back(existingEdges.id(neighbor));
-
-        }
-        neighbors.shrink_to_fit();
-
         specieState spState;
-        spState.id = existingEdges.id(nIt);
-        spState.sp = population[nIt];
-        spState.contacts = neighbors;
+        spState.id = graph.id(node);
+        spState.sp = population[node];
+        spState.contacts.reserve(graph.degree(node));
+        graph.forEachNeighbor(node, [&](Node neighbor) { spState.contacts.push_back(graph.id(neighbor)); });
         result.push_back(spState);
-    }
+    });
     return result;
 }
 
@@ -467,63 +770,288 @@ double   ContactNetwork::getMaxContactsLimitByState(Specie::State state, double
 {
     double result = 0;
     double numConMax = static_cast<double> (size() - 1);
-    for (lemon::FilterEdges<lemon::ListGraph>::NodeIt nIt(existingEdges); nIt != lemon::INVALID; ++nIt)
+    double totalNewContactRate = getTotalNewContactRate();
+    const std::vector<Specie::State> &states = population.getStates();
+    for (size_t id = states.size(); id-- > 0;)
     {
-        if (population[nIt].getState() == state)
+        if (states[id] == state)
         {
-            double meanTheta = getMeanEdgeDeletionRate(nIt);
-            double meanLambda = getMeanEdgeAdditionRate(nIt);
-            double numConStart = population[nIt].getNumberOfContacts();
-            double numConEnd = numberOfContactEstimation(meanLambda, meanTheta, t, numConMax,numConStart);
-            double maxCont = std::max(numConStart, numConEnd);
+            result+= getMaxContactsOfNode(graph.nodeFromId(id), t, numConMax, totalNewContactRate);
+        }
+    }
+    return result;
+}
+
+std::vector<double> ContactNetwork::getMaxContactsLimits(double t, ThreadPool *pool) const
+{
+    LimitsWorkspace workspace;
+    return getMaxContactsLimits(t, workspace, pool);
+}
 
-            double numConExtrema = getExtremaPoint(meanLambda, meanTheta, t, numConMax,numConStart);
-            maxCont = std::max(numConExtrema, maxCont);
+const std::vector<double> &ContactNetwork::getMaxContactsLimits(double t, LimitsWorkspace &workspace,
+                                                                ThreadPool *pool) const
+{
+    sumMaxContacts(t, false, workspace, pool);
+    return workspace.limits;
+}
 
-            maxCont = std::min(maxCont, numConMax);
+std::vector<double> ContactNetwork::getInteractingContactsLimits(double t, ThreadPool *pool) const
+{
+    LimitsWorkspace workspace;
+    return getInteractingContactsLimits(t, workspace, pool);
+}
 
-            result+= maxCont;
+const std::vector<double> &ContactNetwork::getInteractingContactsLimits(double t, LimitsWorkspace &workspace,
+                                                                        ThreadPool *pool) const
+{
+    size_t nStates = model.getNumberOfStates();
+    std::vector<char> &interacting = workspace.interacting;
+    interacting.assign(nStates * nStates, 0);
+    for (const Model::InteractionPair &pair: model.getInteractionPairs())
+    {
+        if (pair.rate > 0)
+        {
+            interacting[pair.anchor * nStates + pair.partner] = 1;
+            interacting[pair.partner * nStates + pair.anchor] = 1;
         }
     }
-    return result;
+    sumMaxContacts(t, true, workspace, pool);
+    return workspace.limits;
 }
 
+void ContactNetwork::sumMaxContacts(double t, bool interactingOnly, LimitsWorkspace &workspace,
+                                    ThreadPool *pool) const
+{
+    constexpr size_t blockSize = 256;
+    double numConMax = static_cast<double> (size() - 1);
+    size_t nStates = model.getNumberOfStates();
+    double totalNewContactRate = getTotalNewContactRate();
+    const std::vector<char> &interacting = workspace.interacting;
+
+    // possible partners of a node of each state: all species of interacting states but the node itself,
+    // with the sums of their rates of establishing contacts (the node itself is subtracted per node)
+    std::vector<double> &numPartners = workspace.numPartners;
+    std::vector<double> &partnerRates = workspace.partnerRates;
+    numPartners.assign(nStates, numConMax);
+    if (interactingOnly)
+    {
+        for (size_t a = 0; a < nStates; a++)
+        {
+            numPartners[a] = 0;
+            for (size_t b = 0; b < nStates; b++)
+            {
+                if (interacting[a * nStates + b])
+                {
+                    numPartners[a] += static_cast<double>(countByState(static_cast<Specie::State>(b))) - (a == b);
+                }
+            }
+        }
 
+        partnerRates.assign(nStates, 0);
+        const std::vector<Specie::State> &states = population.getStates();
+        const std::vector<double> &rates = population.getNewContactRates();
+        for (size_t id = 0; id < states.size(); id++)
+        {
+            if (states[id] == SpecieStore::noSpecie)
+            {
+                continue;
+            }
+            for (size_t a = 0; a < nStates; a++)
+            {
+                partnerRates[a] += interacting[a * nStates + states[id]] ? rates[id] : 0;
+            }
+        }
+    }
 
-Edge ContactNetwork::getComplementEdge(int a, int b)
-{
-    Node nodeU = complementEdges.nodeFromId(a);
-    Node nodeV = complementEdges.nodeFromId(b);
+    std::vector<Node> &nodes = workspace.nodes;
+    nodes.clear();
+    graph.forEachNode([&nodes](Node node) { nodes.push_back(node); });
+
+    // sums of max. contacts of the nodes by state
+    size_t nBlocks = (nodes.size() + blockSize - 1) / blockSize;
+    std::vector<double> &blockSums = workspace.blockSums;
+    blockSums.assign(nBlocks * nStates, 0);
+    auto sumBlock = [&](size_t block)
+    {
+        size_t begin = block * blockSize;
+        size_t count = std::min(nodes.size(), begin + blockSize) - begin;
+
+        // mean rates of the nodes of the block as arrays for the batched estimation
+        std::array<double, blockSize> meanLambda {};
+        std::array<double, blockSize> meanTheta {};
+        std::array<double, blockSize> numConStart {};
+        std::array<double, blockSize> numConMaxOfNode {};
+        for (size_t i = 0; i < count; i++)
+        {
+            const Node &node = nodes[begin + i];
+            meanTheta[i] = getMeanEdgeDeletionRate(node);
+            if (!interactingOnly)
+            {
+                meanLambda[i] = getMeanEdgeAdditionRate(node, totalNewContactRate);
+                numConStart[i] = population[node].getNumberOfContacts();
+                continue;
+            }
+            // only contacts with possible partners, each pair of nodes is an edge with the same mean rates
+            Specie::State state = population[node].getState();
+            const uint32_t *neighbors = neighborStates.data() + static_cast<size_t>(graph.id(node)) * nStates;
+            for (size_t st = 0; st < nStates; st++)
+            {
+                numConStart[i] += interacting[state * nStates + st] ? neighbors[st] : 0;
+            }
+            numConMaxOfNode[i] = numPartners[state];
+
+            // new contacts are added with the mean rate of the possible partners which are not yet neighbours,
+            // the mean over all complement edges is too low for nodes whose partners establish contacts faster
+            double rate = population[node].getNewContactRate();
+            double complementRate = partnerRates[state] - (interacting[state * nStates + state] ? rate : 0);
+            graph.forEachNeighbor(node, [&](Node neighbor)
+            {
+                if (interacting[state * nStates + population[neighbor].getState()])
+                {
+                    complementRate -= population[neighbor].getNewContactRate();
+                }
+            });
+            double counter = numConMaxOfNode[i] - numConStart[i];
+            meanLambda[i] = counter > 0 ? rate * std::max(complementRate, 0.0) / counter : 0;
+        }
+
+        double *sums = blockSums.data() + block * nStates;
+        if (interactingOnly)
+        {
+            // each node has its own 3 sigma margin, contacts of nodes are not independent (an edge of two
+            // interacting states counts for both of its nodes), so margins are not shared within a state
+            std::array<double, blockSize> maxExpectation;
+            std::array<double, blockSize> maxVariance;
+            ContactEstimation::getContactMoments(meanLambda.data(), meanTheta.data(), numConStart.data(), count, t,
+                                                 numConMaxOfNode.data(), maxExpectation.data(), maxVariance.data());
+            for (size_t i = 0; i < count; i++)
+            {
+                size_t state = population[nodes[begin + i]].getState();
+                sums[state] += std::min(maxExpectation[i] + 3 * std::sqrt(maxVariance[i]), numConMaxOfNode[i]);
+            }
+            return;
+        }
+
+        std::array<double, blockSize> maxCont;
+        ContactEstimation::getMaxContacts(meanLambda.data(), meanTheta.data(), numConStart.data(), count, t,
+                                          numConMax, maxCont.data());
 
-    Edge e = lemon::findEdge(complementEdges, nodeU, nodeV);
-    return e;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (maxCont[i] < 0)
+            {
+                std::string msg = "Something went wrong with expectation";
+                throw std::domain_error(msg);
+            }
+            sums[population[nodes[begin + i]].getState()] += maxCont[i];
+        }
+    };
+
+    if (pool == nullptr || nBlocks < 2)
+    {
+        for (size_t block = 0; block < nBlocks; block++)
+        {
+            sumBlock(block);
+        }
+    }
+    else
+    {
+        for (size_t block = 0; block < nBlocks; block++)
+        {
+            pool->submit([&sumBlock, block]() { sumBlock(block); });
+        }
+        pool->wait();
+    }
+
+    std::vector<double> &result = workspace.limits;
+    result.assign(nStates, 0);
+    for (size_t block = 0; block < nBlocks; block++)
+    {
+        for (size_t st = 0; st < nStates; st++)
+        {
+            result[st] += blockSums[block * nStates + st];
+        }
+    }
 }
-Edge ContactNetwork::getEdge(int a, int b)
+
+double ContactNetwork::getMaxContactsOfNode(const Node &node, double t, double numConMax,
+                                           double totalNewContactRate) const
 {
+    double meanTheta = getMeanEdgeDeletionRate(node);
+    double meanLambda = getMeanEdgeAdditionRate(node, totalNewContactRate);
+    double numConStart = population[node].getNumberOfContacts();
+    double numConEnd = numberOfContactEstimation(meanLambda, meanTheta, t, numConMax,numConStart);
+    double maxCont = std::max(numConStart, numConEnd);
 
-    Node nodeU = existingEdges.nodeFromId(a);
-    Node nodeV = existingEdges.nodeFromId(b);
-    Edge e = lemon::findEdge(existingEdges, nodeU, nodeV);
-    return e;
+    double numConExtrema = getExtremaPoint(meanLambda, meanTheta, t, numConMax,numConStart);
+    maxCont = std::max(numConExtrema, maxCont);
 
+    return std::min(maxCont, numConMax);
 }
 
-double ContactNetwork::getMeanEdgeAdditionRate (const Node &complementNode) const
+
+
+ImportedNetwork ContactNetwork::exportNetwork() const
 {
-    double meanLambda = 0;
-    size_t counter = 0;
-    for(lemon::FilterEdges<lemon::ListGraph>::IncEdgeIt cieIt(complementEdges, complementNode); cieIt!=lemon::INVALID; ++cieIt)
-    //for(lemon::ListGraph::IncEdgeIt cieIt(graph, complementNode); cieIt!=lemon::INVALID; ++cieIt)
+    if (static_cast<size_t>(graph.maxNodeId() + 1) != size())
     {
-        meanLambda += getEdgeAdditionRate(cieIt);
-        counter++;
+        std::string msg = "ERROR: network with removed nodes can not be exported!";
+        throw std::domain_error(msg);
     }
 
-    if (counter > 0)
+    ImportedNetwork result;
+    result.nodes.resize(size());
+    graph.forEachNode([&](Node node)
     {
-        meanLambda = meanLambda / counter;
+        SpecieStore::ConstView sp = population[node];
+        result.nodes.at(graph.id(node)) = {sp.getState(), sp.getNewContactRate(), sp.getLooseContactRate()};
+    });
+
+    result.edges.reserve(countEdges());
+    graph.forEachEdge([&](Edge edge)
+    {
+        result.edges.push_back(NetworkImport::edgeKey(graph.id(graph.u(edge)), graph.id(graph.v(edge))));
+    });
+    std::sort(result.edges.begin(), result.edges.end());
+    return result;
+}
+
+Edge ContactNetwork::getComplementEdge(int a, int b)
+{
+    Edge e = graph.edge(graph.nodeFromId(a), graph.nodeFromId(b));
+    return graph.exists(e) ? Edge(ContactGraph::INVALID) : e;
+}
+Edge ContactNetwork::getEdge(int a, int b)
+{
+    Edge e = graph.edge(graph.nodeFromId(a), graph.nodeFromId(b));
+    return graph.exists(e) ? e : Edge(ContactGraph::INVALID);
+}
+
+double ContactNetwork::getTotalNewContactRate() const
+{
+    // species that died have rate 0
+    const std::vector<double> &rates = population.getNewContactRates();
+    return std::accumulate(rates.begin(), rates.end(), 0.0);
+}
+
+double ContactNetwork::getMeanEdgeAdditionRate (const Node &complementNode, double totalNewContactRate) const
+{
+    // complement edges connect the node to all other nodes except its neighbours, rate of an edge is
+    // the product of rates of both nodes, so the sum is rate of the node * sum of rates of these nodes
+    size_t counter = size() - 1 - graph.degree(complementNode);
+    if (counter == 0)
+    {
+        return 0;
     }
 
+    double rate = population[complementNode].getNewContactRate();
+    double complementRate = totalNewContactRate - rate;
+    graph.forEachNeighbor(complementNode, [&](Node neighbor)
+    {
+        complementRate -= population[neighbor].getNewContactRate();
+    });
+
+    double meanLambda = rate * std::max(complementRate, 0.0) / counter;
     return meanLambda;
 }
 
@@ -532,12 +1060,11 @@ double ContactNetwork::getMeanEdgeDeletionRate (const Node &networkNode) const
     double meanTheta = 0;
 
     size_t counter = 0;
-    for(lemon::FilterEdges<lemon::ListGraph>::IncEdgeIt ieIt(existingEdges, networkNode); ieIt!=lemon::INVALID; ++ieIt)
-    //for(lemon::ListGraph::IncEdgeIt ieIt(graph, networkNode); ieIt!=lemon::INVALID; ++ieIt)
+    graph.forEachNeighbor(networkNode, [&](Node neighbor)
     {
-        meanTheta += getEdgeDeletionRate(ieIt);
+        meanTheta += getEdgeDeletionRate(graph.edge(networkNode, neighbor));
         counter++;
-    }
+    });
 
     if (counter > 0)
     {
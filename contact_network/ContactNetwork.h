@@ -7,39 +7,37 @@
  * Graph is simple, i.e only one edg between each pair of nodes. Graph is undirected.
  * infection is not possible (for example, S-S, I-I edges) are undirected and ones with transmission rate > 0
  * for instance edge between Infected (I) and Susceprible (S) is directed (as transmission only possible one direction)
- * Uses LEMON library for graph representation.
- * Graph is represented by two graphs - actual network & complement network. Complement NW is used for
+ * Graph is represented by ContactGraph (or DenseContactGraph, CMake option SSATANX_DENSE_GRAPH) -
+ * actual network & implicit complement network. Complement NW is used for
  * more convenient and direct addition of the edges.
 */
 
 #ifndef ALGO_CONTACTNETWORK_H
 #define ALGO_CONTACTNETWORK_H
 
-#include <lemon/list_graph.h>
-#include <lemon/maps.h>
 #include <random>
 #include "Specie.h"
+#include "SpecieStore.h"
+#include "ContactGraph.h"
+#include "DenseContactGraph.h"
+#include "NetworkImport.h"
 #include "utilities/types.h"
 #include "utilities/Settings.h"
-#include <lemon/adaptors.h>
-
+#include "model/Model.h"
 
+class ThreadPool;
 
 class ContactNetwork {
 
 public:
 
-    ContactNetwork(const Settings& settings) :transmissionRates(graph),
-                                   population(graph),
-                                   filterExistingEdges(graph, false),
-                                   filterComplementEdges(graph, true),
-                                   existingEdges(graph, filterExistingEdges),
-                                   complementEdges(graph, filterComplementEdges)
-
+    ContactNetwork(const Settings& settings) : ContactNetwork(settings, nullptr) {};
 
-                                   {
-                                       init(settings);
-                                   };
+    /*
+     * creates network with given nodes and edges, rates of reactions are taken from settings.
+     */
+    ContactNetwork(const Settings& settings, const ImportedNetwork &initialNetwork) :
+            ContactNetwork(settings, &initialNetwork) {};
 
 
     size_t  size() const; //@return amount of nodes
@@ -48,22 +46,58 @@ public:
 
 /* calculates cumulative sum of rates of particular reactions.
  * Used in SSA & SSATANX to find reaction being executed
- * @return a vector of pairs <cumulative sum, instance> for instances of question.
- * first element of the vector is always pair <0, INVALID> for convenience
+ * propCumSum is overwritten with pairs <cumulative sum, instance> for instances of question,
+ * first element of the vector is always pair <0, INVALID> for convenience.
+ * The capacity of propCumSum is kept, a buffer owned by the caller does not allocate once it is large enough.
+ */
+    void getInteractionRateSum(std::vector<std::pair<double, Edge>> &propCumSum) const; //interactions, e.g. transmission
+    void getEdgeDeletionRateSum(std::vector<std::pair<double, Edge>> &propCumSum) const;
+    void getEdgeAdditionRateSum(std::vector<std::pair<double, Edge>> &propCumSum) const;
+    void getDeathRateSum(std::vector<std::pair<double, Node>> &propCumSum) const;
+    void getTransitionRateSum(std::vector<std::pair<double, Node>> &propCumSum) const; //transitions, e.g. diagnosis
+
+    double  getBirthRateSum()const; //@return rate of births, it does not depend on the population
+
+/*
+ * Rates of deaths and transitions depend only on the state of the specie, so their sums are sums over the states
+ * of amount * rate, O(number of states). A reaction is found by r in (0, propensity] as in the cumulative sums:
+ * the state first, then the specie among the members of the state in O(1).
+ * @return node and r reduced to (0, rate of the node], e.g. to choose the transition
  */
-    std::vector<std::pair<double, Edge>> getTransmissionRateSum() const; //transmission
-    std::vector<std::pair<double, Edge>> getEdgeDeletionRateSum()const;
-    std::vector<std::pair<double, Edge>> getEdgeAdditionRateSum()const;
-    std::vector<std::pair<double, Node>> getDeathRateSum()const;
-    std::vector<std::pair<double, Node>> getDiagnosisRateSum()const;
+    double  getDeathPropensity() const;
+    double  getTransitionPropensity() const;
+    std::pair<Node, double> findDeath(double r) const;
+    std::pair<Node, double> findTransition(double r) const;
 
-    double  getBirthRateSum()const;
+/*
+ * Rate of interactions of an edge depends only on the states of its nodes. Numbers of edges between states and,
+ * for every node, numbers of its neighbours in each state are kept up to date by adding/removing edges, O(1),
+ * and by changes of state, O(degree). The propensity is then a sum over interacting pairs of states.
+ * findInteraction finds the edge by r in (0, propensity], O(species in a state + degree).
+ * @return edge and r reduced to (0, rate of the edge] to choose the interaction
+ */
+    double  getInteractionPropensity() const;
+    std::pair<Edge, double> findInteraction(double r) const;
+
+/*
+ * Fast path of the contact channels for homogeneous contact rates, e.g. new_contact_rate [a, a] and
+ * loose_contact_rate [b, b]: all species have the same rate of loosing contacts and their rate of making contacts
+ * depends only on their state (adaptivity). It is detected at init and dropped for good when a specie breaks it.
+ * Propensities are then closed-form sums over pairs of states, edges are sampled w/o cumulative sums:
+ * deletions uniformly among all edges, additions by rejection from uniform pairs of nodes.
+ */
+    bool    hasHomogeneousContacts() const;
+    double  getEdgeDeletionPropensity() const; //@return sum of rates of edge deletions, O(1)
+    double  getEdgeAdditionPropensity() const; //@return sum of rates of edge additions, O(states^2)
+    size_t  countDeletableEdges() const; //@return number of edges with deletion rate > 0
+    size_t  countAddableEdges() const; //@return number of complement edges with addition rate > 0
+    Edge    sampleEdgeDeletion(std::mt19937_64 &generator) const; //@return edge with prob. of its rate / propensity
+    Edge    sampleEdgeAddition(std::mt19937_64 &generator) const; //@return complement edge, as above
 
 /*
- * @return highest possible transmission rate in network. Since now rate is static,
- * just return transmission rate given by initiating Contact Network.
+ * @return compiled model of reactions on the network
  */
-    double  getTransmissionRateLimit() const;
+    const Model & getModel() const;
 
 /*
  * @return  max. number of contacts susceptible nodes can have during time t.
@@ -71,6 +105,47 @@ public:
 
     double  getMaxContactsLimitByState(Specie::State state, double t) const;
 
+/*
+ * limits of getMaxContactsLimitByState for all states in one pass over the nodes.
+ * Nodes are split into blocks of fixed size which are evaluated by the pool (serially if pool is nullptr)
+ * and summed up in order of the blocks, so the result does not depend on the number of threads.
+ * @return max. number of contacts by state
+ */
+    std::vector<double> getMaxContactsLimits(double t, ThreadPool *pool = nullptr) const;
+
+/*
+ * buffers of the evaluation of the limits kept by the caller, e.g. the look-ahead of SSATANX,
+ * so that they are not allocated for every evaluation
+ */
+    struct LimitsWorkspace
+    {
+        std::vector<char> interacting; // matrix of interacting states, @see sumMaxContacts
+        std::vector<double> numPartners;
+        std::vector<double> partnerRates; // sums of rates of establishing contacts of possible partners by state
+        std::vector<Node> nodes;
+        std::vector<double> blockSums;
+        std::vector<double> limits; // result of the last evaluation
+    };
+
+    //@return workspace.limits
+    const std::vector<double> &getMaxContactsLimits(double t, LimitsWorkspace &workspace,
+                                                    ThreadPool *pool = nullptr) const;
+
+/*
+ * as getMaxContactsLimits, but only contacts which can lead to an interaction are counted. The contacts of a node
+ * with its possible partners (species of states interacting with its state, @see Model::getInteractionPairs) are
+ * projected from its current number of such neighbours and the mean rate of adding contacts to the possible partners
+ * which are not yet its neighbours, at most the number of possible partners, so contacts with species which can not
+ * interact, e.g. of an infected node with other infected ones, do not inflate the limit.
+ * The limit of a state is the sum of the limits of its nodes, max. expectation + 3 sigma of the max. variance
+ * (@see ContactEstimation::getContactMoments), at most the number of possible partners of the node.
+ * States only change by reactions, so the limit holds until the next one. States w/o interactions have limit 0.
+ * @return max. number of contacts with possible partners by state
+ */
+    std::vector<double> getInteractingContactsLimits(double t, ThreadPool *pool = nullptr) const;
+    const std::vector<double> &getInteractingContactsLimits(double t, LimitsWorkspace &workspace,
+                                                            ThreadPool *pool = nullptr) const; //@return workspace.limits
+
 
  /*
  * Adding edge to the network. input - reference to the edge from complement network
@@ -93,11 +168,17 @@ public:
 
     /*
     * Executing particular reactions.
+    * Interactions & transitions: r in (0, rate of edge/node] chooses the reaction of the model if several are possible.
     */
-    void executeTransmission(Edge & edge, double time);
-    void executeDiagnosis(Node & node, double time);
+    void executeInteraction(Edge & edge, double r, double time);
+    void executeTransition(Node & node, double r, double time);
     void executeDeath(Node & node);
-    void executeBirth(double rStart, double rBound);
+
+    /*
+     * adds a specie in the birth state w/o contacts, its rates of contacts are sampled as for the initial species.
+     * Its node gets the id of a died specie if there is one.
+     */
+    void executeBirth(double time, std::mt19937_64 &generator);
 
     /*
      * Gets degree distribution of the network.
@@ -108,17 +189,48 @@ public:
     double  getEdgeAdditionRate(const Edge &complementEdge) const;
     double  getEdgeDeletionRate(const Edge &networkEdge) const;
 
-    Edge getComplementEdge(int a, int b); //@return complement edge by given nodes ids
-    Edge getEdge(int a, int b);//@return edge of actual network by given nodes ids
+    /*
+     * @return nodes and edges of the network, can be used to create networks with the same topology.
+     * Requires node ids to be dense, i.e. no node died.
+     */
+    ImportedNetwork exportNetwork() const;
+
+    /*
+     * lookup of edges by ids of their nodes in constant time (pair key of ContactGraph).
+     * An edge keeps its value when it is added or removed, so edges taken from rate sums need no lookup.
+     */
+    Edge getComplementEdge(int a, int b); //@return complement edge by given nodes ids, INVALID if they are connected
+    Edge getEdge(int a, int b);//@return edge of actual network by given nodes ids, INVALID if not connected
 
 
 private:
 
-    void initRates(double transmRate, double diagnRate, double dRate, double bRate);
+    ContactNetwork(const Settings& settings, const ImportedNetwork *initialNetwork) :model(Model::compile(settings))
+                                   {
+                                       init(settings, initialNetwork);
+                                   };
 
-    double getMeanEdgeAdditionRate (const Node &complementNode) const;
+    double getTotalNewContactRate() const; //@return sum of rates of establishing contacts of all nodes
+
+    /*
+     * sums of max. contacts during time t of the nodes by state into workspace.limits
+     * @param interactingOnly only contacts with species of interacting states are counted, given by the matrix
+     * workspace.interacting (a * number of states + b); false - all contacts
+     */
+    void sumMaxContacts(double t, bool interactingOnly, LimitsWorkspace &workspace, ThreadPool *pool) const;
+
+    /*
+     * mean rate of adding the complement edges of the node.
+     * @param totalNewContactRate sum of rates of establishing contacts of all nodes
+     */
+    double getMeanEdgeAdditionRate (const Node &complementNode, double totalNewContactRate) const;
     double getMeanEdgeDeletionRate (const Node &networkNode) const;
 
+    /*
+     * @return max. number of contacts the node can have during time t, at most numConMax
+     */
+    double getMaxContactsOfNode(const Node &node, double t, double numConMax, double totalNewContactRate) const;
+
     double numberOfContactEstimation(double meanEdgeAdditionRate, double meanEdgeDeletionRate, double t,
                                      double Cmax, double C0) const;
 
@@ -166,26 +278,79 @@ private:
                            double Cmax, double C0) const;
 
 
-    void init(const Settings&settings);
+    /*
+     * initialises the network either randomly, from network files given in settings or from initialNetwork if not null.
+     */
+    void init(const Settings&settings, const ImportedNetwork *initialNetwork);
 
+    /*
+     * creates species in amounts given by settings, rates of establishing/loosing contacts are sampled.
+     */
+    void initPopulation(const std::unordered_map<std::string, SpecieSettings> &statesSettings,
+                        size_t maxContacts, std::mt19937_64 &generator);
 
-    lemon::ListGraph graph;
+    /*
+     * adds edges of the imported edge list to the network.
+     */
+    void importEdges(const std::vector<uint64_t> &edgeKeys);
 
-    lemon::ListGraph::EdgeMap<double> transmissionRates;
+    /*
+     * changes state of the node and applies rates & adaptivity of the new state.
+     */
+    void changeState(Node node, Specie::State st, double time);
+
+    /*
+     * enables the fast path if rates of all species are homogeneous, must be called before edges are added
+     */
+    void initHomogeneousContacts();
+
+    /*
+     * checks that the specie of the node keeps rates homogeneous (after birth or change of state),
+     * drops the fast path otherwise
+     */
+    void checkHomogeneousContacts(Node node);
+
+    /*
+     * adds delta to the number of edges between the states of nodes u and v and to the neighbours of u, v in them
+     */
+    void countStateEdge(Node u, Node v, int delta);
+
+    size_t countStatePairs(Specie::State a, Specie::State b) const; //@return number of node pairs in states a, b
+
+    /*
+     * @see getDeathPropensity, findDeath. rate is the rate of a specie in a state given by the model
+     */
+    double getStatePropensity(double (Model::*rate)(Specie::State) const) const;
+    std::pair<Node, double> findByState(double r, double (Model::*rate)(Specie::State) const) const;
+
+
+    Model model;
+
+#ifdef SSATANX_DENSE_GRAPH
+    DenseContactGraph graph; // nodes are classified by state of their specie
+#else
+    ContactGraph graph; // nodes are classified by state of their specie
+#endif
 
     std::uniform_real_distribution<double> looseContactDistribution;
     std::uniform_real_distribution<double> createContactDistribution;
 
-    double transmissionRate;
-    double diagnosisRate;
     double birthRate;
-    std::vector<double> deathRate;
+    Specie::State birthState; // state of born species
+
+    std::vector<size_t> stateEdges; // number of edges between states a and b at a * number of states + b and b, a
+    std::vector<uint32_t> neighborStates; // number of neighbours of node in state st at id * number of states + st
+
+    static constexpr double maxTrialsPerAddition = 64; // expected, more - sampleEdgeAddition uses cumulative sums
+    bool homogeneousContacts = false;
+    double homogeneousLooseContactRate = 0; // rate of loosing contacts of all species
+    std::vector<double> stateNewContactRate; // rate of making contacts of species in each state, < 0 if none yet
+
+    SpecieStore population; // indexed by id of the node
 
-    lemon::ListGraph::NodeMap<Specie> population;
-    lemon::ListGraph::EdgeMap<bool> filterExistingEdges;
-    lemon::ListGraph::EdgeMap<bool> filterComplementEdges;
-    lemon::FilterEdges<lemon::ListGraph> existingEdges;
-    lemon::FilterEdges<lemon::ListGraph> complementEdges;
+    // buffers reused by all calls: neighbours of a node whose contacts are cut, cumulative rates of sampleEdgeAddition
+    std::vector<Node> cutNeighbors;
+    mutable std::vector<std::pair<double, Edge>> additionRates;
 
 };
 
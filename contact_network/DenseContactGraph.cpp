@@ -0,0 +1,173 @@
+//
+// Graph of a contact network as bit matrix, see DenseContactGraph.h
+//
+
+#include <algorithm>
+#include "DenseContactGraph.h"
+
+void DenseContactGraph::init(size_t n)
+{
+    capacity = n;
+    words = (n + 63) / 64;
+    adjacency.assign(n * words, 0);
+    alive.assign(words, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        set(alive.data(), static_cast<int>(i));
+    }
+    classMasks.clear();
+    nodeClass.assign(n, noClass);
+    degrees.assign(n, 0);
+    degreeCount.assign(n + 1, 0);
+    degreeCount[0] = static_cast<uint32_t>(n);
+    maxDegree = 0;
+    freeIds.clear();
+    nNodes = n;
+    nEdges = 0;
+}
+
+DenseContactGraph::Edge DenseContactGraph::edge(Node a, Node b) const
+{
+    if (a.id == b.id || !valid(a) || !valid(b))
+    {
+        return ContactGraph::INVALID;
+    }
+    return Edge(a.id, b.id);
+}
+
+bool DenseContactGraph::addEdge(Edge edge)
+{
+    if (!valid(Node(edge.u)) || !valid(Node(edge.v)) || exists(edge))
+    {
+        return false;
+    }
+    set(row(edge.u), edge.v);
+    set(row(edge.v), edge.u);
+    changeDegree(edge.u, 1);
+    changeDegree(edge.v, 1);
+    nEdges++;
+    return true;
+}
+
+bool DenseContactGraph::removeEdge(Edge edge)
+{
+    if (!exists(edge))
+    {
+        return false;
+    }
+    reset(row(edge.u), edge.v);
+    reset(row(edge.v), edge.u);
+    changeDegree(edge.u, -1);
+    changeDegree(edge.v, -1);
+    nEdges--;
+    return true;
+}
+
+void DenseContactGraph::erase(Node node)
+{
+    forEachNeighbor(node, [this, node](Node neighbor)
+    {
+        reset(row(neighbor.id), node.id);
+        changeDegree(neighbor.id, -1);
+        nEdges--;
+    });
+    uint64_t *adjacent = row(node.id);
+    std::fill(adjacent, adjacent + words, 0);
+    changeDegree(node.id, -static_cast<int>(degrees[node.id]));
+    degreeCount[0]--; // dead nodes are not counted
+
+    setClass(node, noClass);
+    reset(alive.data(), node.id);
+    freeIds.push_back(node.id);
+    nNodes--;
+}
+
+DenseContactGraph::Node DenseContactGraph::addNode()
+{
+    int id;
+    if (!freeIds.empty())
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else
+    {
+        id = static_cast<int>(degrees.size());
+        if (degrees.size() == capacity)
+        {
+            grow(std::max<size_t>(64, capacity + capacity / 2));
+        }
+        degrees.push_back(0);
+        nodeClass.push_back(noClass);
+    }
+    set(alive.data(), id);
+    degreeCount[0]++;
+    nNodes++;
+    return Node(id);
+}
+
+void DenseContactGraph::grow(size_t newCapacity)
+{
+    size_t newWords = (newCapacity + 63) / 64;
+    std::vector<uint64_t> newAdjacency(newCapacity * newWords, 0);
+    for (size_t u = 0; u < degrees.size(); u++)
+    {
+        std::copy(row(static_cast<int>(u)), row(static_cast<int>(u)) + words, newAdjacency.data() + u * newWords);
+    }
+    adjacency.swap(newAdjacency);
+
+    alive.resize(newWords, 0);
+    degreeCount.resize(newCapacity + 1, 0);
+    for (std::vector<uint64_t> &mask: classMasks)
+    {
+        mask.resize(newWords, 0);
+    }
+    capacity = newCapacity;
+    words = newWords;
+}
+
+void DenseContactGraph::changeDegree(int u, int delta)
+{
+    degreeCount[degrees[u]]--;
+    degrees[u] += delta;
+    degreeCount[degrees[u]]++;
+    maxDegree = std::max(maxDegree, degrees[u]);
+    while (maxDegree > 0 && degreeCount[maxDegree] == 0)
+    {
+        maxDegree--;
+    }
+}
+
+int DenseContactGraph::selectNeighbor(int u, uint32_t rank) const
+{
+    const uint64_t *adjacent = row(u);
+    size_t w = 0;
+    for (uint32_t bitsInWord = std::popcount(adjacent[w]); rank >= bitsInWord; bitsInWord = std::popcount(adjacent[w]))
+    {
+        rank -= bitsInWord;
+        w++;
+    }
+    uint64_t bits = adjacent[w];
+    for (uint32_t i = 0; i < rank; i++)
+    {
+        bits &= bits - 1;
+    }
+    return static_cast<int>(64 * w + std::countr_zero(bits));
+}
+
+void DenseContactGraph::setClass(Node node, unsigned char cls)
+{
+    if (nodeClass[node.id] != noClass)
+    {
+        reset(classMasks[nodeClass[node.id]].data(), node.id);
+    }
+    if (cls != noClass)
+    {
+        if (cls >= classMasks.size())
+        {
+            classMasks.resize(cls + 1, std::vector<uint64_t>(words, 0));
+        }
+        set(classMasks[cls].data(), node.id);
+    }
+    nodeClass[node.id] = cls;
+}
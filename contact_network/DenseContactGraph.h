@@ -0,0 +1,199 @@
+/*
+ * Graph of a contact network with the adjacency stored as a dense bit matrix, n x n bits
+ * (about 112 MB for 30k nodes). Has the interface of ContactGraph, the representation is chosen at compile time
+ * by the CMake option SSATANX_DENSE_GRAPH.
+ *
+ * Edges are looked up, added and removed by setting single bits. Nodes of each class have a bit mask, so
+ * edges between classes a and b are rows of nodes of a combined with the mask of b, 64 pairs per instruction,
+ * and the complement graph is the inverted matrix.
+ *
+ * A uniformly random edge is a random (node, rank of neighbour < max. degree) pair, accepted if the node has
+ * that many neighbours; the max. degree is kept exact with a histogram of degrees.
+ *
+ * Ids of removed nodes are reused by added nodes. If there is none, the matrix grows by half its rows
+ * (and columns), so adding nodes costs amortised O(n / 64) words.
+*/
+
+#ifndef ALGO_DENSECONTACTGRAPH_H
+#define ALGO_DENSECONTACTGRAPH_H
+
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "ContactGraph.h"
+
+class DenseContactGraph {
+public:
+    using Node = ContactGraph::Node;
+    using Edge = ContactGraph::Edge;
+    static constexpr unsigned char noClass = ContactGraph::noClass;
+
+    /*
+     * removes all nodes and edges and creates n nodes w/o edges and class
+     */
+    void init(size_t n);
+
+    size_t countNodes() const { return nNodes; }
+    size_t countEdges() const { return nEdges; }
+    int maxNodeId() const { return static_cast<int>(degrees.size()) - 1; }
+
+    static int id(Node node) { return node.id; }
+    static Node nodeFromId(int id) { return Node(id); }
+    static Node u(Edge edge) { return Node(edge.u); }
+    static Node v(Edge edge) { return Node(edge.v); }
+    static Node oppositeNode(Node node, Edge edge) { return Node(edge.u == node.id ? edge.v : edge.u); }
+
+    Edge edge(Node a, Node b) const; //@see ContactGraph::edge
+
+    bool valid(Node node) const { return node.id >= 0 && node.id <= maxNodeId() && test(alive.data(), node.id); }
+    bool exists(Edge edge) const { return edge.u >= 0 && test(row(edge.u), edge.v); }
+
+    bool addEdge(Edge edge);
+    bool removeEdge(Edge edge);
+
+    void erase(Node node);
+
+    Node addNode(); //@see ContactGraph::addNode
+
+    size_t degree(Node node) const { return degrees[node.id]; }
+
+    void setClass(Node node, unsigned char cls);
+
+    /*
+     * @return uniformly chosen existing edge, INVALID if there is none (@see ContactGraph::randomEdge)
+     */
+    template <typename Generator>
+    Edge randomEdge(Generator &generator) const
+    {
+        if (nEdges == 0)
+        {
+            return ContactGraph::INVALID;
+        }
+        std::uniform_int_distribution<int> nodeDistribution(0, maxNodeId());
+        std::uniform_int_distribution<uint32_t> rankDistribution(0, maxDegree - 1);
+        while (true)
+        {
+            int u = nodeDistribution(generator);
+            uint32_t rank = rankDistribution(generator);
+            if (rank < degrees[u])
+            {
+                return Edge(u, selectNeighbor(u, rank));
+            }
+        }
+    }
+
+    template <typename F>
+    void forEachNeighbor(Node node, F f) const
+    {
+        const uint64_t *adjacent = row(node.id);
+        for (size_t w = 0; w < words; w++)
+        {
+            forEachBit(adjacent[w], w, [&](int v) { f(Node(v)); });
+        }
+    }
+
+    /*
+     * calls f(Node) for all nodes in descending order of ids
+     */
+    template <typename F>
+    void forEachNode(F f) const
+    {
+        for (int id = maxNodeId(); id >= 0; id--)
+        {
+            if (test(alive.data(), id))
+            {
+                f(Node(id));
+            }
+        }
+    }
+
+    template <typename F>
+    void forEachEdge(F f) const
+    {
+        forEachPair(alive.data(), alive.data(), false, true, f);
+    }
+
+    template <typename F>
+    void forEachEdgeBetween(unsigned char a, unsigned char b, F f) const
+    {
+        if (a < classMasks.size() && b < classMasks.size())
+        {
+            forEachPair(classMasks[a].data(), classMasks[b].data(), false, a == b, f);
+        }
+    }
+
+    template <typename F>
+    void forEachComplementEdge(F f) const
+    {
+        forEachPair(alive.data(), alive.data(), true, true, f);
+    }
+
+private:
+    uint64_t *row(int u) { return adjacency.data() + static_cast<size_t>(u) * words; }
+    const uint64_t *row(int u) const { return adjacency.data() + static_cast<size_t>(u) * words; }
+
+    static bool test(const uint64_t *bits, int i) { return (bits[i / 64] >> (i % 64)) & 1; }
+    static void set(uint64_t *bits, int i) { bits[i / 64] |= uint64_t(1) << (i % 64); }
+    static void reset(uint64_t *bits, int i) { bits[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+
+    /*
+     * calls f(id) for every bit set in word w of a bit set
+     */
+    template <typename F>
+    static void forEachBit(uint64_t bits, size_t w, F f)
+    {
+        while (bits != 0)
+        {
+            f(static_cast<int>(64 * w + std::countr_zero(bits)));
+            bits &= bits - 1;
+        }
+    }
+
+    /*
+     * calls f(Edge) for pairs (u, v) with u in rows, v in columns and bit u, v of the matrix (inverted if complement)
+     * set, only for u < v if upper (otherwise a pair with both nodes in rows and columns would be visited twice).
+     */
+    template <typename F>
+    void forEachPair(const uint64_t *rows, const uint64_t *columns, bool complement, bool upper, F f) const
+    {
+        uint64_t flip = complement ? ~uint64_t(0) : 0;
+        for (size_t wu = 0; wu < words; wu++)
+        {
+            forEachBit(rows[wu], wu, [&](int u)
+            {
+                const uint64_t *adjacent = row(u);
+                size_t first = upper ? static_cast<size_t>(u) / 64 : 0;
+                for (size_t w = first; w < words; w++)
+                {
+                    uint64_t bits = (adjacent[w] ^ flip) & columns[w];
+                    if (upper && w == first)
+                    {
+                        bits &= (~uint64_t(0) << (u % 64)) << 1; // v > u
+                    }
+                    forEachBit(bits, w, [&](int v) { f(Edge(u, v)); });
+                }
+            });
+        }
+    }
+
+    void grow(size_t newCapacity); // reallocates the matrix for newCapacity nodes
+
+    void changeDegree(int u, int delta); // updates degree of u, the histogram and max. degree
+    int selectNeighbor(int u, uint32_t rank) const; //@return id of the neighbour of u with given rank in order of ids
+
+    size_t capacity = 0; // number of rows
+    size_t words = 0; // 64-bit words per row
+    std::vector<uint64_t> adjacency;
+    std::vector<uint64_t> alive;
+    std::vector<std::vector<uint64_t>> classMasks; // nodes of each class
+    std::vector<unsigned char> nodeClass;
+    std::vector<uint32_t> degrees;
+    std::vector<uint32_t> degreeCount; // number of living nodes of each degree
+    uint32_t maxDegree = 0;
+    std::vector<int> freeIds; // ids of removed nodes
+    size_t nNodes = 0;
+    size_t nEdges = 0;
+};
+
+#endif //ALGO_DENSECONTACTGRAPH_H
@@ -0,0 +1,309 @@
+//
+// Import of empirical contact networks, see NetworkImport.h
+//
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "NetworkImport.h"
+
+namespace
+{
+    /*
+     * read-only memory mapping of a whole file, unmapped on destruction
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &fileName)
+        {
+            int fd = ::open(fileName.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                std::string msg = "Can not open network file " + fileName;
+                throw std::domain_error(msg);
+            }
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                std::string msg = "Can not read network file " + fileName;
+                throw std::domain_error(msg);
+            }
+            length = static_cast<size_t>(st.st_size);
+
+            if (length > 0)
+            {
+                void *ptr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (ptr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    std::string msg = "Can not map network file " + fileName;
+                    throw std::domain_error(msg);
+                }
+                ::madvise(ptr, length, MADV_SEQUENTIAL);
+                data = static_cast<const char *>(ptr);
+            }
+            ::close(fd);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile()
+        {
+            if (data != nullptr)
+            {
+                ::munmap(const_cast<char *>(data), length);
+            }
+        }
+
+        const char *begin() const { return data; }
+        const char *end() const { return data + length; }
+        size_t size() const { return length; }
+
+    private:
+        const char *data = nullptr;
+        size_t length = 0;
+    };
+
+    bool isSeparator(char c)
+    {
+        return c == ' ' || c == '\t' || c == ',' || c == '\r';
+    }
+
+    const char *skipLine(const char *it, const char *end)
+    {
+        const char *newLine = static_cast<const char *>(std::memchr(it, '\n', end - it));
+        return newLine == nullptr ? end : newLine + 1;
+    }
+}
+
+std::vector<uint64_t> NetworkImport::readEdges(const std::string &fileName, bool binary)
+{
+    MappedFile file(fileName);
+    std::vector<uint64_t> edges;
+
+    if (binary)
+    {
+        if (file.size() % (2 * sizeof(uint32_t)) != 0)
+        {
+            std::string msg = "Invalid binary edge list " + fileName;
+            throw std::domain_error(msg);
+        }
+
+        size_t nEdges = file.size() / (2 * sizeof(uint32_t));
+        edges.resize(nEdges);
+        const char *it = file.begin();
+        for (size_t i = 0; i < nEdges; i++)
+        {
+            uint32_t pair[2];
+            std::memcpy(pair, it, sizeof(pair));
+            it += sizeof(pair);
+            if (pair[0] == pair[1])
+            {
+                std::string msg = "Self loop in edge list " + fileName;
+                throw std::domain_error(msg);
+            }
+            edges[i] = edgeKey(pair[0], pair[1]);
+        }
+    }
+    else
+    {
+        // split the buffer into chunks at line boundaries and parse them in parallel
+        size_t nChunks = std::max<size_t>(1, std::thread::hardware_concurrency());
+        nChunks = std::min(nChunks, file.size() / (1 << 20) + 1);
+
+        std::vector<const char *> bounds;
+        bounds.push_back(file.begin());
+        for (size_t i = 1; i < nChunks; i++)
+        {
+            const char *bound = std::max(bounds.back(), file.begin() + file.size() * i / nChunks);
+            bounds.push_back(bound == file.begin() ? bound : skipLine(bound - 1, file.end()));
+        }
+        bounds.push_back(file.end());
+
+        std::vector<std::vector<uint64_t>> parts(nChunks);
+        std::vector<std::exception_ptr> errors(nChunks);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < nChunks; i++)
+        {
+            workers.emplace_back([&, i]()
+            {
+                try
+                {
+                    parts[i] = parseTextEdges(bounds[i], bounds[i + 1]);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &worker: workers)
+        {
+            worker.join();
+        }
+        for (auto &error: errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        size_t nEdges = 0;
+        for (const auto &part: parts)
+        {
+            nEdges += part.size();
+        }
+        edges.reserve(nEdges);
+        for (const auto &part: parts)
+        {
+            edges.insert(edges.end(), part.begin(), part.end());
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+std::vector<uint64_t> NetworkImport::parseTextEdges(const char *begin, const char *end)
+{
+    std::vector<uint64_t> edges;
+    edges.reserve((end - begin) / 8);
+
+    const char *it = begin;
+    while (it < end)
+    {
+        while (it < end && isSeparator(*it))
+        {
+            it++;
+        }
+        if (it == end || *it == '\n' || *it == '#')
+        {
+            it = skipLine(it, end);
+            continue;
+        }
+
+        uint32_t ids[2];
+        for (auto &id: ids)
+        {
+            while (it < end && isSeparator(*it))
+            {
+                it++;
+            }
+            auto [ptr, ec] = std::from_chars(it, end, id);
+            if (ec != std::errc())
+            {
+                std::string msg = "Invalid line in edge list: " + std::string(it, skipLine(it, end));
+                throw std::domain_error(msg);
+            }
+            it = ptr;
+        }
+        if (ids[0] == ids[1])
+        {
+            std::string msg = "Self loop in edge list: " + std::to_string(ids[0]);
+            throw std::domain_error(msg);
+        }
+        edges.push_back(edgeKey(ids[0], ids[1]));
+        it = skipLine(it, end);
+    }
+    return edges;
+}
+
+std::vector<ImportedNode> NetworkImport::readNodes(const std::string &fileName, bool binary)
+{
+    MappedFile file(fileName);
+    std::vector<ImportedNode> nodes;
+
+    if (binary)
+    {
+        static_assert(sizeof(NodeRecord) == 24, "unexpected padding of NodeRecord");
+        if (file.size() % sizeof(NodeRecord) != 0)
+        {
+            std::string msg = "Invalid binary node file " + fileName;
+            throw std::domain_error(msg);
+        }
+
+        size_t nNodes = file.size() / sizeof(NodeRecord);
+        nodes.reserve(nNodes);
+        const char *it = file.begin();
+        for (size_t i = 0; i < nNodes; i++)
+        {
+            NodeRecord record;
+            std::memcpy(&record, it, sizeof(record));
+            it += sizeof(record);
+            if (record.state > 255)
+            {
+                std::string msg = "Invalid state in node file " + fileName;
+                throw std::domain_error(msg);
+            }
+            nodes.push_back({static_cast<Specie::State>(record.state), record.newContactRate, record.looseContactRate});
+        }
+    }
+    else
+    {
+        const char *it = file.begin();
+        while (it < file.end())
+        {
+            const char *lineEnd = skipLine(it, file.end());
+            std::istringstream line(std::string(it, lineEnd));
+            it = lineEnd;
+
+            std::string st;
+            if (!(line >> st) || st.front() == '#')
+            {
+                continue;
+            }
+
+            ImportedNode node{};
+            node.state = parseState(st);
+            if (!(line >> node.newContactRate >> node.looseContactRate))
+            {
+                std::string msg = "Invalid line in node file " + fileName;
+                throw std::domain_error(msg);
+            }
+            nodes.push_back(node);
+        }
+    }
+
+    return nodes;
+}
+
+Specie::State NetworkImport::parseState(const std::string &st)
+{
+    if (st == "S")
+    {
+        return Specie::S;
+    }
+    if (st == "I")
+    {
+        return Specie::I;
+    }
+    if (st == "D")
+    {
+        return Specie::D;
+    }
+
+    // states of other models are given by their index
+    unsigned int index = 0;
+    auto [ptr, ec] = std::from_chars(st.data(), st.data() + st.size(), index);
+    if (ec != std::errc() || ptr != st.data() + st.size() || index > 255)
+    {
+        std::string msg = "Invalid state in node file: " + st;
+        throw std::domain_error(msg);
+    }
+    return static_cast<Specie::State>(index);
+}
@@ -0,0 +1,84 @@
+/*
+ * Import of empirical contact networks as initial condition.
+ *
+ * Two kinds of files are supported:
+ * - edge list: pairs of node ids (0-based) that are connected at t = 0;
+ * - node attributes: epidemic state, rate of establishing (lambda) and rate of loosing (theta) contacts per node.
+ *
+ * Both files can be given either as text or as binary. Files are memory-mapped; text edge lists are
+ * parsed in parallel, chunks split at line boundaries.
+ *
+ * Text edge list: one edge per line, "u v" (separated by spaces, tabs or commas), lines starting with '#' are ignored.
+ * Binary edge list: sequence of pairs of little-endian uint32_t (u, v).
+ * Text node attributes: one node per line, "state lambda theta", state is S, I, D or index of the state in the model.
+ * Binary node attributes: sequence of NodeRecord.
+*/
+
+#ifndef ALGO_NETWORKIMPORT_H
+#define ALGO_NETWORKIMPORT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Specie.h"
+
+struct ImportedNode
+{
+    Specie::State state;
+    double newContactRate;
+    double looseContactRate;
+};
+
+/*
+ * contact network as a list of nodes (index is node id) and keys of existing edges.
+ * Used to initialise several contact networks with the same topology without re-sampling/re-reading.
+ */
+struct ImportedNetwork
+{
+    std::vector<ImportedNode> nodes;
+    std::vector<uint64_t> edges;
+};
+
+class NetworkImport {
+public:
+
+    /*
+     * on-disk layout of one node in a binary node attributes file (24 bytes, little-endian)
+     */
+    struct NodeRecord
+    {
+        uint32_t state; // index of the state in the model, built-in model: 0 - S, 1 - I, 2 - D
+        uint32_t reserved;
+        double newContactRate;
+        double looseContactRate;
+    };
+
+    /*
+     * reads an edge list.
+     * @return sorted vector of unique edge keys (@see edgeKey), self loops are rejected.
+     */
+    static std::vector<uint64_t> readEdges(const std::string &fileName, bool binary);
+
+    /*
+     * reads node attributes.
+     * @return vector of node attributes, index of the element is node id
+     */
+    static std::vector<ImportedNode> readNodes(const std::string &fileName, bool binary);
+
+    /*
+     * @return key of undirected edge (a, b): smaller id in upper 32 bits, larger id in lower 32 bits
+     */
+    static uint64_t edgeKey(uint32_t a, uint32_t b)
+    {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+private:
+
+    NetworkImport(){};
+
+    static std::vector<uint64_t> parseTextEdges(const char *begin, const char *end);
+    static Specie::State parseState(const std::string &st);
+};
+
+#endif //ALGO_NETWORKIMPORT_H
@@ -18,7 +18,7 @@ class Specie {
  * "I" - infected, "D" - diagnosed.
  */
 public:
-    enum State {S, I, D}; //Susceptible, Infected, Recovered, Diagnosed
+    enum State : unsigned char {S, I, D}; //Susceptible, Infected, Diagnosed. Models can define further states
 
 public:
 
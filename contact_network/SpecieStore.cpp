@@ -0,0 +1,51 @@
+//
+// Structure of arrays of species of a contact network, see SpecieStore.h
+//
+
+#include "SpecieStore.h"
+
+void SpecieStore::resize(size_t n)
+{
+    stateCount[noSpecie] += n - state.size();
+    state.resize(n, noSpecie);
+    numberOfContacts.resize(n, 0);
+    deathRate.resize(n, 0);
+    newContactRate.resize(n, 0);
+    looseContactRate.resize(n, 0);
+    diagnosisRate.resize(n, 0);
+    stateChangeTime.resize(n, 0);
+    posInMembers.resize(n, 0);
+}
+
+void SpecieStore::remove(const ContactGraph::Node &node)
+{
+    size_t id = ContactGraph::id(node);
+    setState(id, noSpecie);
+    numberOfContacts[id] = 0;
+    deathRate[id] = 0;
+    newContactRate[id] = 0;
+    looseContactRate[id] = 0;
+    diagnosisRate[id] = 0;
+}
+
+void SpecieStore::setState(size_t id, Specie::State st)
+{
+    Specie::State old = state[id];
+    if (old != noSpecie)
+    {
+        // the last member takes the place of id
+        std::vector<uint32_t> &oldMembers = members[old];
+        uint32_t last = oldMembers.back();
+        oldMembers[posInMembers[id]] = last;
+        posInMembers[last] = posInMembers[id];
+        oldMembers.pop_back();
+    }
+    if (st != noSpecie)
+    {
+        posInMembers[id] = static_cast<uint32_t>(members[st].size());
+        members[st].push_back(static_cast<uint32_t>(id));
+    }
+    stateCount[old]--;
+    stateCount[st]++;
+    state[id] = st;
+}
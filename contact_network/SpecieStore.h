@@ -0,0 +1,134 @@
+/*
+ * Attributes of all species of a contact network stored as structure of arrays, indexed by id of the node.
+ *
+ * Loops over the population usually need one or two attributes (state, rate of death, number of contacts),
+ * with one array per attribute they read only these. Single species are accessed through SpecieView,
+ * which has the interface of Specie and converts to a Specie (e.g. for snapshots of the network).
+ *
+ * Ids without a specie (not used yet or the specie died) have state noSpecie, their slots stay as tombstones.
+ * Ids of the species of each state are kept in a set (swap with the last member on removal), rates of deaths
+ * and transitions depend only on the state, so a specie with such a rate is found in O(1) (@see ContactNetwork).
+ * Max. number of contacts is the same for all species (all other living species), it is derived from the number
+ * of living species instead of being stored per specie, so a death changes it in O(1).
+ * Loops over ids go in descending order, the order of nodes of ContactGraph, so sums over species
+ * and the reactions selected from them are the same as with iteration over the graph.
+*/
+
+#ifndef ALGO_SPECIESTORE_H
+#define ALGO_SPECIESTORE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Specie.h"
+#include "ContactGraph.h"
+
+/*
+ * specie of one node of the store. Setters are available only for views of non-const stores.
+ */
+template <typename Store>
+class SpecieView {
+public:
+    SpecieView(Store &store, size_t id) : store(&store), id(id) {};
+
+    [[nodiscard]] size_t getMaxNumberOfContacts() const { return store->size() - 1; }
+    [[nodiscard]] size_t getNumberOfContacts() const { return store->numberOfContacts[id]; }
+    [[nodiscard]] double getNewContactRate() const { return store->newContactRate[id]; }
+    [[nodiscard]] double getLooseContactRate() const { return store->looseContactRate[id]; }
+    [[nodiscard]] double getDeathRate() const { return store->deathRate[id]; }
+    [[nodiscard]] double getDiagnosisRate() const { return store->diagnosisRate[id]; }
+    [[nodiscard]] double getLastStateChangeTime() const { return store->stateChangeTime[id]; }
+    [[nodiscard]] Specie::State getState() const { return store->state[id]; }
+
+    void incNumberOfContacts() { store->numberOfContacts[id]++; }
+    void decNumberOfContacts() { store->numberOfContacts[id]--; }
+    void setNewContactRate(double newContRate) { store->newContactRate[id] = newContRate; }
+    void setLooseContactRate(double looseContRate) { store->looseContactRate[id] = looseContRate; }
+    void setDiagnosisRate(double diagnRate) { store->diagnosisRate[id] = diagnRate; }
+    void setDeathRate(double dRate) { store->deathRate[id] = dRate; }
+    void changeState(Specie::State st, double time)
+    {
+        store->setState(id, st);
+        store->stateChangeTime[id] = time;
+    }
+
+    /*
+     * stores all attributes of the given specie, except max. number of contacts
+     */
+    SpecieView &operator=(const Specie &sp)
+    {
+        store->numberOfContacts[id] = sp.getNumberOfContacts();
+        setNewContactRate(sp.getNewContactRate());
+        setLooseContactRate(sp.getLooseContactRate());
+        setDiagnosisRate(sp.getDiagnosisRate());
+        setDeathRate(sp.getDeathRate());
+        changeState(sp.getState(), sp.getLastStateChangeTime());
+        return *this;
+    }
+
+    operator Specie() const
+    {
+        Specie sp(getMaxNumberOfContacts(), getNumberOfContacts(), getDeathRate(), getNewContactRate(),
+                  getLooseContactRate(), getState(), getDiagnosisRate());
+        sp.changeState(getState(), getLastStateChangeTime());
+        return sp;
+    }
+
+private:
+    Store *store;
+    size_t id;
+};
+
+class SpecieStore {
+public:
+    static constexpr Specie::State noSpecie = static_cast<Specie::State>(255);
+
+    using View = SpecieView<SpecieStore>;
+    using ConstView = SpecieView<const SpecieStore>;
+
+    /*
+     * resizes the store to ids [0, n), new ids have no specie
+     */
+    void resize(size_t n);
+
+    View operator[](const ContactGraph::Node &node) { return View(*this, ContactGraph::id(node)); }
+    ConstView operator[](const ContactGraph::Node &node) const { return ConstView(*this, ContactGraph::id(node)); }
+
+    void remove(const ContactGraph::Node &node); // the specie of the node died
+
+    size_t size() const { return state.size() - stateCount[noSpecie]; } //@return amount of living species
+
+    size_t count(Specie::State st) const { return stateCount[st]; } //@return amount of species in state st
+
+    /*
+     * @return ids of the species in state st (not noSpecie), in no particular order
+     */
+    const std::vector<uint32_t> &getMembers(Specie::State st) const { return members[st]; }
+
+    /*
+     * arrays of the attributes, indexed by id of the node
+     */
+    const std::vector<Specie::State> &getStates() const { return state; }
+    const std::vector<double> &getDeathRates() const { return deathRate; }
+    const std::vector<double> &getNewContactRates() const { return newContactRate; }
+    const std::vector<double> &getDiagnosisRates() const { return diagnosisRate; }
+
+private:
+    friend View;
+    friend ConstView;
+
+    void setState(size_t id, Specie::State st); // moves id to the set of state st
+
+    std::vector<Specie::State> state;
+    std::vector<uint32_t> numberOfContacts;
+    std::vector<double> deathRate;
+    std::vector<double> newContactRate;
+    std::vector<double> looseContactRate;
+    std::vector<double> diagnosisRate;
+    std::vector<double> stateChangeTime;
+    std::array<size_t, 256> stateCount {}; // amount of ids in each state, noSpecie included
+    std::array<std::vector<uint32_t>, 256> members; // ids in each state, noSpecie is not kept
+    std::vector<uint32_t> posInMembers; // position of the id in the set of its state
+};
+
+#endif //ALGO_SPECIESTORE_H
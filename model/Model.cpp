@@ -0,0 +1,312 @@
+//
+// Model of the epidemic process, see Model.h
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "Model.h"
+#include "ModelPolicies.h"
+
+Model Model::compile(const Settings &settings)
+{
+    Model model;
+    std::unordered_map<std::string, SpecieSettings> statesSettings = settings.getStateSettings();
+
+    if (!settings.hasModel())
+    {
+        for (const char *name: {"S", "I", "D"})
+        {
+            model.addState(name, statesSettings.at(name).deathRate);
+        }
+
+        model.addInteraction({"S", "I"}, {"I", "I"}, settings.getTransmissionRate());
+        //for edges Diagnosed "D"- Susceptible "S" transmission rate is 50% lower than for edges "I" - "S"
+        model.addInteraction({"S", "D"}, {"I", "D"}, settings.getTransmissionRate() * SIDModel::diagnosedTransmissionFactor);
+        model.addTransition("I", "D", settings.getDiagnosisRate());
+
+        //adaptivity: as soon as diagnosed, cut all contacts and reduce new contact rate to 30%
+        model.addAdaptivity("D", SIDModel::diagnosedCutsContacts, SIDModel::diagnosedNewContactFactor);
+        model.builtIn = true;
+    }
+    else
+    {
+        for (const std::string &name: settings.getStateNames())
+        {
+            model.addState(name, statesSettings.at(name).deathRate);
+        }
+        for (const ::Interaction &interaction: settings.getInteractions())
+        {
+            model.addInteraction(interaction.fromStates, interaction.toStates, getConstantRate(interaction.rate));
+        }
+        for (const ::Transition &transition: settings.getTransitions())
+        {
+            model.addTransition(transition.fromState, transition.toState, getConstantRate(transition.rate));
+        }
+        for (const Adaptivity &adaptivity: settings.getAdaptivity())
+        {
+            model.addAdaptivity(adaptivity.state, adaptivity.cutContacts, adaptivity.newContactFactor);
+        }
+    }
+
+    model.finalize();
+    return model;
+}
+
+size_t Model::getNumberOfStates() const
+{
+    return stateNames.size();
+}
+
+const std::string &Model::getStateName(Specie::State st) const
+{
+    return stateNames.at(st);
+}
+
+Specie::State Model::getState(const std::string &name) const
+{
+    auto it = std::find(stateNames.begin(), stateNames.end(), name);
+    if (it == stateNames.end())
+    {
+        std::string msg = "Unknown state in model: " + name;
+        throw std::domain_error(msg);
+    }
+    return static_cast<Specie::State>(std::distance(stateNames.begin(), it));
+}
+
+const std::vector<Model::Reaction> &Model::getReactions() const
+{
+    return reactions;
+}
+
+unsigned Model::getDependencies(Channel channel) const
+{
+    return dependencies[channel];
+}
+
+bool Model::isBuiltIn() const
+{
+    return builtIn;
+}
+
+bool Model::isEpidemic(Channel channel)
+{
+    return channel == Interaction || channel == Transition || channel == Death || channel == Birth;
+}
+
+double Model::getDeathRate(Specie::State st) const
+{
+    return deathRates[st];
+}
+
+double Model::getTransitionRate(Specie::State st) const
+{
+    return transitionRates[st];
+}
+
+double Model::getInteractionRate(Specie::State a, Specie::State b) const
+{
+    return interactionRates[pairIndex(a, b)];
+}
+
+const std::vector<Model::InteractionPair> &Model::getInteractionPairs() const
+{
+    return interactionPairs;
+}
+
+bool Model::isCuttingContacts(Specie::State st) const
+{
+    return cutContacts[st];
+}
+
+double Model::getNewContactFactor(Specie::State st) const
+{
+    return newContactFactors[st];
+}
+
+const Model::Reaction &Model::selectTransition(Specie::State st, double r) const
+{
+    const std::vector<size_t> &candidates = transitionsFrom[st];
+    double pSum = 0;
+    for (size_t id: candidates)
+    {
+        pSum += reactions[id].rate;
+        if (pSum >= r)
+        {
+            return reactions[id];
+        }
+    }
+    // r exceeds the sum only by rounding
+    return reactions[candidates.back()];
+}
+
+const Model::EdgeReaction &Model::selectInteraction(Specie::State a, Specie::State b, double r) const
+{
+    const std::vector<EdgeReaction> &candidates = edgeReactions[pairIndex(a, b)];
+    double pSum = 0;
+    for (const EdgeReaction &candidate: candidates)
+    {
+        pSum += reactions[candidate.reaction].rate;
+        if (pSum >= r)
+        {
+            return candidate;
+        }
+    }
+    // r exceeds the sum only by rounding
+    return candidates.back();
+}
+
+void Model::addState(const std::string &name, double deathRate)
+{
+    if (std::find(stateNames.begin(), stateNames.end(), name) != stateNames.end())
+    {
+        std::string msg = "State defined twice: " + name;
+        throw std::domain_error(msg);
+    }
+    stateNames.push_back(name);
+    deathRates.push_back(deathRate);
+    cutContacts.push_back(false);
+    newContactFactors.push_back(1);
+}
+
+void Model::addTransition(const std::string &from, const std::string &to, double rate)
+{
+    Specie::State st = getState(from);
+    reactions.push_back({Transition, from + "->" + to, st, getState(to), st, st, rate});
+}
+
+void Model::addInteraction(const std::vector<std::string> &from, const std::vector<std::string> &to, double rate)
+{
+    if (from.size() != 2 || to.size() != 2)
+    {
+        std::string msg = "Interaction has to describe states of exactly two species";
+        throw std::domain_error(msg);
+    }
+    reactions.push_back({Interaction, from.at(0) + "+" + from.at(1) + "->" + to.at(0) + "+" + to.at(1),
+                         getState(from.at(0)), getState(to.at(0)), getState(from.at(1)), getState(to.at(1)), rate});
+}
+
+void Model::addAdaptivity(const std::string &state, bool cut, double newContactFactor)
+{
+    Specie::State st = getState(state);
+    cutContacts.at(st) = cut;
+    newContactFactors.at(st) = newContactFactor;
+}
+
+void Model::finalize()
+{
+    size_t nStates = getNumberOfStates();
+    transitionRates.assign(nStates, 0);
+    transitionsFrom.assign(nStates, {});
+    interactionRates.assign(nStates * nStates, 0);
+    edgeReactions.assign(nStates * nStates, {});
+    interactionPairs.clear();
+
+    bool changesDeathRate = false;
+    bool changesTransitionRate = false;
+    bool changesContacts = false;
+    auto checkStateChange = [&](Specie::State from, Specie::State to)
+    {
+        if (from == to)
+        {
+            return;
+        }
+        changesDeathRate = changesDeathRate || deathRates[from] != deathRates[to];
+        changesTransitionRate = changesTransitionRate || !transitionsFrom[from].empty() || !transitionsFrom[to].empty();
+        changesContacts = changesContacts || cutContacts[to] || newContactFactors[to] != 1;
+    };
+
+    for (size_t id = 0; id < reactions.size(); id++)
+    {
+        const Reaction &reaction = reactions[id];
+        if (reaction.channel == Transition)
+        {
+            transitionRates[reaction.from] += reaction.rate;
+            transitionsFrom[reaction.from].push_back(id);
+        }
+    }
+
+    for (size_t id = 0; id < reactions.size(); id++)
+    {
+        const Reaction &reaction = reactions[id];
+        if (reaction.channel != Interaction)
+        {
+            continue;
+        }
+
+        interactionRates[pairIndex(reaction.from, reaction.partnerFrom)] += reaction.rate;
+        edgeReactions[pairIndex(reaction.from, reaction.partnerFrom)].push_back({id, false});
+        if (reaction.from != reaction.partnerFrom)
+        {
+            interactionRates[pairIndex(reaction.partnerFrom, reaction.from)] += reaction.rate;
+            edgeReactions[pairIndex(reaction.partnerFrom, reaction.from)].push_back({id, true});
+        }
+
+        auto pairIt = std::find_if(interactionPairs.begin(), interactionPairs.end(), [&](const InteractionPair &pair)
+        {
+            return (pair.anchor == reaction.from && pair.partner == reaction.partnerFrom) ||
+                   (pair.anchor == reaction.partnerFrom && pair.partner == reaction.from);
+        });
+        if (pairIt == interactionPairs.end() && reaction.rate > 0)
+        {
+            interactionPairs.push_back({reaction.from, reaction.partnerFrom, 0});
+        }
+    }
+
+    for (InteractionPair &pair: interactionPairs)
+    {
+        pair.rate = getInteractionRate(pair.anchor, pair.partner);
+    }
+
+    // dependencies of channels changing states of species
+    auto epidemicDependencies = [&](Channel channel)
+    {
+        changesDeathRate = false;
+        changesTransitionRate = false;
+        changesContacts = false;
+        for (const Reaction &reaction: reactions)
+        {
+            if (reaction.channel == channel)
+            {
+                checkStateChange(reaction.from, reaction.to);
+                checkStateChange(reaction.partnerFrom, reaction.partnerTo);
+            }
+        }
+
+        unsigned result = 1u << Interaction;
+        if (changesContacts)
+        {
+            result |= (1u << EdgeDeletion) | (1u << EdgeAddition);
+        }
+        if (changesTransitionRate)
+        {
+            result |= 1u << Transition;
+        }
+        if (changesDeathRate)
+        {
+            result |= 1u << Death;
+        }
+        return result;
+    };
+
+    dependencies[EdgeDeletion] = (1u << EdgeDeletion) | (1u << EdgeAddition) | (1u << Interaction);
+    dependencies[EdgeAddition] = (1u << EdgeDeletion) | (1u << EdgeAddition) | (1u << Interaction);
+    dependencies[Interaction] = epidemicDependencies(Interaction);
+    dependencies[Transition] = epidemicDependencies(Transition);
+    dependencies[Death] = (1u << NumberOfChannels) - 1;
+    dependencies[Birth] = (1u << NumberOfChannels) - 1;
+}
+
+double Model::getConstantRate(const rateParameters &rate)
+{
+    if (rate.distribution != "none")
+    {
+        std::string msg = "Only constant rates are supported for transitions and interactions";
+        throw std::domain_error(msg);
+    }
+    return rate.parameters.at(0);
+}
+
+size_t Model::pairIndex(Specie::State a, Specie::State b) const
+{
+    return static_cast<size_t>(a) * stateNames.size() + b;
+}
@@ -0,0 +1,140 @@
+/*
+ * Model of the epidemic process on the contact network.
+ *
+ * Describes states of species, transitions (reactions of one specie, e.g. diagnosis I -> D),
+ * interactions (reactions of two connected species, e.g. transmission S + I -> I + I),
+ * death rates and adaptivity (change of contact behaviour when entering a state).
+ *
+ * Model is compiled once from settings into dense tables indexed by states and reaction ids,
+ * so the simulation loop does not need any string comparison or map lookup.
+ * If the config does not describe a model, the built-in SID model is used:
+ *  S + I -> I + I with transmission rate, S + D -> I + D with half of transmission rate,
+ *  I -> D with diagnosis rate, diagnosed species cut all contacts and reduce rate of new contacts to 30%.
+ *
+ * Reactions are grouped into channels. Engines keep one propensity per channel; the reaction
+ * inside a channel is chosen by the rate of the selected edge or node (@see selectTransition, selectInteraction).
+*/
+
+#ifndef ALGO_MODEL_H
+#define ALGO_MODEL_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "contact_network/Specie.h"
+#include "utilities/Settings.h"
+
+class Model {
+public:
+
+    enum Channel : unsigned char {EdgeDeletion, EdgeAddition, Interaction, Transition, Death, Birth};
+    static constexpr size_t NumberOfChannels = 6;
+
+    struct Reaction
+    {
+        Channel channel;
+        std::string name;
+        Specie::State from;        // state of the (first) specie before reaction
+        Specie::State to;          // state of the (first) specie after reaction
+        Specie::State partnerFrom; // interactions only: state of the second specie before reaction
+        Specie::State partnerTo;   // interactions only: state of the second specie after reaction
+        double rate;
+    };
+
+    /*
+     * interaction that can happen on an edge with given states of nodes.
+     * swapped = true if the first node of the edge plays the role of the partner.
+     */
+    struct EdgeReaction
+    {
+        size_t reaction;
+        bool swapped;
+    };
+
+    /*
+     * pair of states which species interact, used for estimation of the upper limit of interactions.
+     * anchor - state of the specie that changes, partner - state of the second specie.
+     */
+    struct InteractionPair
+    {
+        Specie::State anchor;
+        Specie::State partner;
+        double rate; // total rate of an edge between anchor and partner
+    };
+
+    /*
+     * compiles model described in settings, or the built-in SID model if settings do not describe any.
+     */
+    static Model compile(const Settings &settings);
+
+    [[nodiscard]] size_t getNumberOfStates() const;
+    [[nodiscard]] const std::string &getStateName(Specie::State st) const;
+    [[nodiscard]] Specie::State getState(const std::string &name) const; //@return state by its name, throws if unknown
+
+    [[nodiscard]] const std::vector<Reaction> &getReactions() const;
+
+    /*
+     * @return bit mask of channels (bit i - channel i) which propensities change after a reaction
+     * of the given channel was executed
+     */
+    [[nodiscard]] unsigned getDependencies(Channel channel) const;
+    [[nodiscard]] bool isBuiltIn() const; //@return true if this is the built-in SID model, @see SIDModel
+    [[nodiscard]] static bool isEpidemic(Channel channel); //@return true for channels that change species or their states
+
+    [[nodiscard]] double getDeathRate(Specie::State st) const;
+    [[nodiscard]] double getTransitionRate(Specie::State st) const; //@return total rate of transitions leaving the state
+    [[nodiscard]] double getInteractionRate(Specie::State a, Specie::State b) const; //@return total rate of an edge a - b
+
+    [[nodiscard]] const std::vector<InteractionPair> &getInteractionPairs() const;
+
+    [[nodiscard]] bool isCuttingContacts(Specie::State st) const;
+    [[nodiscard]] double getNewContactFactor(Specie::State st) const;
+
+    /*
+     * chooses transition of a specie in state st.
+     * @param r value in (0, getTransitionRate(st)]
+     */
+    [[nodiscard]] const Reaction &selectTransition(Specie::State st, double r) const;
+
+    /*
+     * chooses interaction of an edge between species in states a and b.
+     * @param r value in (0, getInteractionRate(a, b)]
+     */
+    [[nodiscard]] const EdgeReaction &selectInteraction(Specie::State a, Specie::State b, double r) const;
+
+private:
+
+    Model() = default;
+
+    void addState(const std::string &name, double deathRate);
+    void addTransition(const std::string &from, const std::string &to, double rate);
+    void addInteraction(const std::vector<std::string> &from, const std::vector<std::string> &to, double rate);
+    void addAdaptivity(const std::string &state, bool cutContacts, double newContactFactor);
+
+    /*
+     * builds dense lookup tables and dependency lists after all reactions were added
+     */
+    void finalize();
+
+    static double getConstantRate(const rateParameters &rate);
+
+    [[nodiscard]] size_t pairIndex(Specie::State a, Specie::State b) const;
+
+    std::vector<std::string> stateNames;
+    std::vector<Reaction> reactions;
+
+    std::vector<double> deathRates;
+    std::vector<double> transitionRates;
+    std::vector<double> interactionRates;
+    std::vector<std::vector<size_t>> transitionsFrom;
+    std::vector<std::vector<EdgeReaction>> edgeReactions;
+    std::vector<InteractionPair> interactionPairs;
+
+    std::vector<char> cutContacts;
+    std::vector<double> newContactFactors;
+
+    std::array<unsigned, NumberOfChannels> dependencies {};
+    bool builtIn = false;
+};
+
+#endif //ALGO_MODEL_H
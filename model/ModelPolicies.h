@@ -0,0 +1,97 @@
+/*
+ * Compile-time model policies for the simulation engines.
+ *
+ * Engines are instantiated with a policy that tells which channels have to be recomputed
+ * after a reaction and whether the closed-form upper limit of the built-in model can be used.
+ *  SIDModel     - the built-in S/I/D model: states, rate factors, adaptivity and dependencies are constants,
+ *                 so the compiler can unroll the channel loops and drop the table lookups.
+ *  DynamicModel - any model compiled from the config, everything is read from Model at runtime.
+ *
+ * Engines choose SIDModel if Model::isBuiltIn(), DynamicModel otherwise.
+*/
+
+#ifndef ALGO_MODELPOLICIES_H
+#define ALGO_MODELPOLICIES_H
+
+#include <array>
+#include <utility>
+#include "Model.h"
+
+struct SIDModel
+{
+    static constexpr bool builtIn = true;
+
+    static constexpr size_t NumberOfStates = 3;
+    static constexpr Specie::State susceptible = Specie::S;
+    static constexpr Specie::State infected = Specie::I;
+    static constexpr Specie::State diagnosed = Specie::D;
+
+    //rate factors and adaptivity of diagnosed species
+    static constexpr double diagnosedTransmissionFactor = 0.5; //D - S edges transmit with 50% of the rate of I - S
+    static constexpr bool diagnosedCutsContacts = true;        //diagnosis cuts all contacts
+    static constexpr double diagnosedNewContactFactor = 0.3;   //diagnosed establish new contacts with 30% of their rate
+
+    static constexpr unsigned allChannels = (1u << Model::NumberOfChannels) - 1;
+    static constexpr unsigned contactChannels = (1u << Model::EdgeDeletion) | (1u << Model::EdgeAddition) |
+                                                (1u << Model::Interaction);
+
+    /*
+     * dependencies of the channels, conservative: death rates of S, I and D may differ
+     * (Interaction: S -> I), diagnosis changes contacts (Transition: I -> D), births and deaths change the population
+     */
+    static constexpr std::array<unsigned, Model::NumberOfChannels> dependencies
+    {
+        contactChannels,                                                              // EdgeDeletion
+        contactChannels,                                                              // EdgeAddition
+        (1u << Model::Interaction) | (1u << Model::Transition) | (1u << Model::Death), // Interaction
+        allChannels,                                                                  // Transition
+        allChannels,                                                                  // Death
+        allChannels                                                                   // Birth
+    };
+
+    static constexpr unsigned getDependencies(const Model &, Model::Channel channel)
+    {
+        return dependencies[channel];
+    }
+};
+
+struct DynamicModel
+{
+    static constexpr bool builtIn = false;
+
+    static unsigned getDependencies(const Model &model, Model::Channel channel)
+    {
+        return model.getDependencies(channel);
+    }
+};
+
+/*
+ * unrolled selection of the channel which cumulative propensity first reaches searchBound.
+ * @param pSum in: 0, out: cumulative propensity of the channels before the selected one
+ * @return index of the channel, N if searchBound exceeds the sum (only by rounding)
+ */
+template <size_t N>
+inline size_t selectChannel(const std::array<double, N> &propensities, double searchBound, double &pSum)
+{
+    return [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        size_t selected = N;
+        (void) ((propensities[I] > 0 && pSum + propensities[I] >= searchBound ?
+                 (selected = I, true) : (pSum += propensities[I], false)) || ...);
+        return selected;
+    }(std::make_index_sequence<N>{});
+}
+
+/*
+ * unrolled call of f(channel) for every channel which bit is set in the mask
+ */
+template <typename F>
+inline void forEachChannel(unsigned mask, F &&f)
+{
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        ((mask & (1u << I) ? f(static_cast<Model::Channel>(I)) : void()), ...);
+    }(std::make_index_sequence<Model::NumberOfChannels>{});
+}
+
+#endif //ALGO_MODELPOLICIES_H
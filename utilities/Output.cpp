@@ -0,0 +1,101 @@
+//
+// Writing of simulation results to json output.
+//
+
+#include "Output.h"
+
+void saveInitialStates(nlohmann::ordered_json &output, const ContactNetwork &contNetwork, const Settings& settings)
+{
+    const Model &model = contNetwork.getModel();
+    for (size_t st = 0; st < model.getNumberOfStates(); st++)
+    {
+        const std::string &name = model.getStateName(static_cast<Specie::State>(st));
+        output["initial_states"][st][name] = contNetwork.countByState(static_cast<Specie::State>(st));
+    }
+    output["start_edges"] = contNetwork.countEdges();
+
+    output["rate_of_make_a_new_contact"] = {settings.getNewConactRateParameters().a, settings.getNewConactRateParameters().b};
+    output["rate_of_loose_a_contact"] = {settings.getLooseConactRateParameters().a, settings.getLooseConactRateParameters().b};
+    output["birth_rate"] = settings.getBirthRate();
+    output["diagnosis_rate"] = settings.getDiagnosisRate();
+    output["transmission_rate"] = settings.getTransmissionRate();
+
+    if (settings.hasModel())
+    {
+        for (const Model::Reaction &reaction: model.getReactions())
+        {
+            output["reactions"][reaction.name] = reaction.rate;
+        }
+    }
+}
+
+void saveProfile(nlohmann::ordered_json &output, const Profiler &profiler)
+{
+    if constexpr (!Profiler::enabled)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < Profiler::NumberOfPhases; i++)
+    {
+        auto phase = static_cast<Profiler::Phase>(i);
+        output["profile"]["phases"][Profiler::getPhaseName(phase)]["calls"] = profiler.getCalls(phase);
+        output["profile"]["phases"][Profiler::getPhaseName(phase)]["milliseconds"] = profiler.getMilliseconds(phase);
+    }
+    for (size_t i = 0; i < Profiler::NumberOfCounters; i++)
+    {
+        auto counter = static_cast<Profiler::Counter>(i);
+        output["profile"]["counters"][Profiler::getCounterName(counter)] = profiler.getCount(counter);
+    }
+}
+
+void saveThinningEfficiency(nlohmann::ordered_json &output, const LookAheadPolicy &policy, size_t nAcceptance,
+                            size_t nThin)
+{
+    size_t nProposals = nAcceptance + nThin;
+    output["look_ahead_policy"] = policy.getName();
+    output["thinning_efficiency"] = nProposals == 0 ? 0.0 : static_cast<double>(nAcceptance) / nProposals;
+}
+
+void saveEngineStatistics(nlohmann::ordered_json &output, const AutoEngine &engine)
+{
+    for (size_t i = 0; i < AutoEngine::NumberOfEngines; i++)
+    {
+        auto e = static_cast<AutoEngine::Engine>(i);
+        const AutoEngine::EngineStatistics &statistics = engine.getStatistics(e);
+        output["engines"][AutoEngine::getEngineName(e)]["segments"] = statistics.segments;
+        output["engines"][AutoEngine::getEngineName(e)]["simulated_time"] = statistics.simulatedTime;
+        output["engines"][AutoEngine::getEngineName(e)]["milliseconds"] = statistics.seconds * 1000;
+    }
+}
+
+void saveOutput(nlohmann::ordered_json &output, const ContactNetwork &contNetwork, const NetworkStorage &nwStorage)
+{
+    const Model &model = contNetwork.getModel();
+    for (size_t st = 0; st < model.getNumberOfStates(); st++)
+    {
+        const std::string &name = model.getStateName(static_cast<Specie::State>(st));
+        output["final_states"][st][name] = contNetwork.countByState(static_cast<Specie::State>(st));
+    }
+
+
+    size_t i = 0;
+    for (const auto &item : nwStorage)
+    {
+        size_t j = 0;
+        output["networkStates"][i]["time"] = item.first;
+        for (const auto &spcs : item.second)
+        {
+            output["networkStates"][i]["nw_states"][j]["id"] = spcs.id;
+            output["networkStates"][i]["nw_states"][j]["state"] = spcs.sp.getState();
+            output["networkStates"][i]["nw_states"][j]["rate_of_make_a_new_contact"] = spcs.sp.getNewContactRate();
+            output["networkStates"][i]["nw_states"][j]["rate_of_loose_a_contact"] = spcs.sp.getLooseContactRate();
+            output["networkStates"][i]["nw_states"][j]["death_rate"] = spcs.sp.getDeathRate();
+            output["networkStates"][i]["nw_states"][j]["diagnosis_rate"] = spcs.sp.getDiagnosisRate();
+            output["networkStates"][i]["nw_states"][j]["neighbors"] = spcs.contacts;
+            j ++;
+        }
+        i++;
+
+    }
+}
@@ -0,0 +1,44 @@
+//
+// Writing of simulation results to json output.
+//
+
+#ifndef ALGO_OUTPUT_H
+#define ALGO_OUTPUT_H
+
+#include "nlohmann/json.h"
+#include "algorithms/AutoEngine.h"
+#include "algorithms/LookAheadPolicy.h"
+#include "contact_network/ContactNetwork.h"
+#include "utilities/Profiler.h"
+#include "utilities/Settings.h"
+#include "utilities/types.h"
+
+/*
+ * writes initial amounts of species, number of edges and rates of the reactions
+ */
+void saveInitialStates(nlohmann::ordered_json &output, const ContactNetwork &contNetwork, const Settings& settings);
+
+/*
+ * writes final amounts of species and all stored network states
+ */
+void saveOutput(nlohmann::ordered_json &output, const ContactNetwork &contNetwork, const NetworkStorage &nwStorage);
+
+/*
+ * writes calls and time of the phases and counters of the profiler as "profile",
+ * nothing if profiling is not compiled in
+ */
+void saveProfile(nlohmann::ordered_json &output, const Profiler &profiler);
+
+/*
+ * writes the look-ahead policy of SSATAN-X and its thinning efficiency, the ratio of accepted to all
+ * (accepted and thinned) proposals
+ */
+void saveThinningEfficiency(nlohmann::ordered_json &output, const LookAheadPolicy &policy, size_t nAcceptance,
+                            size_t nThin);
+
+/*
+ * writes segments, simulated time and wall-clock time of both engines of an automatic run as "engines"
+ */
+void saveEngineStatistics(nlohmann::ordered_json &output, const AutoEngine &engine);
+
+#endif //ALGO_OUTPUT_H
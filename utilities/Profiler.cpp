@@ -0,0 +1,43 @@
+//
+// Phase-level profile of a simulation run, see Profiler.h
+//
+
+#include "Profiler.h"
+
+thread_local Profiler *Profiler::active = nullptr;
+
+const char *Profiler::getPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case LookAhead:
+            return "look_ahead";
+        case TauLeap:
+            return "tau_leap";
+        case PropensityUpdate:
+            return "propensity_update";
+        case ReactionExecution:
+            return "reaction_execution";
+        case Snapshot:
+            return "snapshot";
+    }
+    return "";
+}
+
+const char *Profiler::getCounterName(Counter counter)
+{
+    switch (counter)
+    {
+        case LeapsAccepted:
+            return "leaps_accepted";
+        case LeapsRejected:
+            return "leaps_rejected";
+        case SSAFallbackSteps:
+            return "ssa_fallback_steps";
+        case EpidemicReactions:
+            return "epidemic_reactions";
+        case ContactReactions:
+            return "contact_reactions";
+    }
+    return "";
+}
@@ -0,0 +1,151 @@
+/*
+ * Phase-level profile of a simulation run.
+ *
+ * A Profiler collects number of calls and total time of the phases of the algorithms and counters of tau-leaping.
+ * The profiler of the current run is activated for the calling thread by Profiler::Scope, timers and counters
+ * in the algorithms add to the active profiler of their thread, if any (so replicates of a sweep on a thread pool
+ * are profiled separately).
+ *
+ * Profiling is compiled in only with SSATANX_PROFILING defined (CMake option SSATANX_PROFILING, ON by default),
+ * otherwise timers and counters are empty and removed by the compiler.
+*/
+
+#ifndef ALGO_PROFILER_H
+#define ALGO_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "utilities/TraceRecorder.h"
+
+class Profiler {
+public:
+
+    enum Phase : unsigned char
+    {
+        LookAhead,         // SSATANX: upper limit of propensities over the look-ahead time
+        TauLeap,           // SSATANX: tau-leaping of contact dynamics up to the next candidate reaction,
+                           // TauLeap: contact reactions of accepted leaps
+        PropensityUpdate,  // rebuild of cumulative rates of an epidemic channel (all channels for SSA)
+        ReactionExecution, // execution of a selected reaction
+        Snapshot           // copy of the network state into the storage
+    };
+    static constexpr size_t NumberOfPhases = 5;
+
+    enum Counter : unsigned char
+    {
+        LeapsAccepted,
+        LeapsRejected,
+        SSAFallbackSteps,  // single reactions executed when tau is too small for leaping (contact dynamics only
+                           // in SSATANX)
+        EpidemicReactions, // executed reactions changing states of species
+        ContactReactions   // executed edge additions and deletions, single or within a leap
+    };
+    static constexpr size_t NumberOfCounters = 5;
+
+#ifdef SSATANX_PROFILING
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    static const char *getPhaseName(Phase phase);
+    static const char *getCounterName(Counter counter);
+
+    [[nodiscard]] uint64_t getCalls(Phase phase) const { return calls[phase]; }
+    [[nodiscard]] double getMilliseconds(Phase phase) const { return nanoseconds[phase] * 1e-6; }
+    [[nodiscard]] uint64_t getCount(Counter counter) const { return counters[counter]; }
+
+    /*
+     * adds n to the counter of the active profiler of this thread
+     */
+    static void count(Counter counter, uint64_t n = 1)
+    {
+        if constexpr (enabled)
+        {
+            if (active != nullptr)
+            {
+                active->counters[counter] += n;
+            }
+        }
+    }
+
+    /*
+     * activates the profiler for the calling thread until the end of the scope
+     */
+    class Scope {
+    public:
+        explicit Scope(Profiler &profiler) : previous(active)
+        {
+            active = &profiler;
+        }
+        ~Scope()
+        {
+            active = previous;
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Profiler *previous;
+    };
+
+    /*
+     * measures the time until the end of the scope and adds it to the phase of the active profiler,
+     * records the phase as a span if a trace recorder is active (@see TraceRecorder)
+     */
+    class Timer {
+    public:
+        explicit Timer([[maybe_unused]] Phase phase)
+        {
+            if constexpr (enabled)
+            {
+                profiler = active;
+                tracing = TraceRecorder::isActive();
+                this->phase = phase;
+                if (profiler != nullptr || tracing)
+                {
+                    start = std::chrono::steady_clock::now();
+                }
+            }
+        }
+        ~Timer()
+        {
+            if constexpr (enabled)
+            {
+                if (profiler == nullptr && !tracing)
+                {
+                    return;
+                }
+                auto end = std::chrono::steady_clock::now();
+                if (profiler != nullptr)
+                {
+                    profiler->calls[phase]++;
+                    profiler->nanoseconds[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                }
+                if (tracing)
+                {
+                    TraceRecorder::record(getPhaseName(phase), start, end);
+                }
+            }
+        }
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+    private:
+        Profiler *profiler = nullptr;
+        bool tracing = false;
+        Phase phase = LookAhead;
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+
+    std::array<uint64_t, NumberOfPhases> calls {};
+    std::array<uint64_t, NumberOfPhases> nanoseconds {};
+    std::array<uint64_t, NumberOfCounters> counters {};
+
+    static thread_local Profiler *active;
+};
+
+#endif //ALGO_PROFILER_H
@@ -13,6 +13,91 @@ uint Settings::getSeed() const
     return seed;
 }
 
+bool Settings::hasNetworkFile() const
+{
+    return !networkSettings.edgeFile.empty();
+}
+
+NetworkSettings Settings::getNetworkSettings() const
+{
+    return networkSettings;
+}
+
+std::vector<std::string> Settings::getStateNames() const
+{
+    return stateNames;
+}
+
+bool Settings::hasModel() const
+{
+    return model;
+}
+
+std::vector<Transition> Settings::getTransitions() const
+{
+    return transitions;
+}
+
+std::vector<Interaction> Settings::getInteractions() const
+{
+    return interactions;
+}
+
+std::vector<Adaptivity> Settings::getAdaptivity() const
+{
+    return adaptivity;
+}
+
+bool Settings::hasSweep() const
+{
+    return sweep;
+}
+
+SweepSettings Settings::getSweepSettings() const
+{
+    return sweepSettings;
+}
+
+bool Settings::hasSimulationSeed() const
+{
+    return simulationSeed != 0;
+}
+
+uint64_t Settings::getSimulationSeed() const
+{
+    return simulationSeed;
+}
+
+bool Settings::hasTrace() const
+{
+    return !traceFile.empty();
+}
+
+std::string Settings::getTraceFile() const
+{
+    return traceFile;
+}
+
+size_t Settings::getLookAheadThreads() const
+{
+    return lookAheadThreads;
+}
+
+LookAheadSettings Settings::getLookAheadSettings() const
+{
+    return lookAheadSettings;
+}
+
+double Settings::getTauLeapEpsilon() const
+{
+    return tauLeapEpsilon;
+}
+
+void Settings::setSeed(uint s)
+{
+    seed = s;
+}
+
 distParameters Settings::getLooseConactRateParameters()const
 {
     return looseContactParameters;
@@ -33,10 +118,15 @@ size_t Settings::getNumberOfEdges() const
     return numOfEdges;
 }
 
-/*double Settings::getBirthRate() const
+double Settings::getBirthRate() const
 {
     return birthRate;
-}*/
+}
+
+std::string Settings::getBirthState() const
+{
+    return birthState;
+}
 
 double Settings::getDiagnosisRate() const
 {
@@ -61,7 +151,11 @@ void Settings::parseSettings(const std::string & configFileName)
     std::stringstream jsonStr;
     jsonStr << confFile.rdbuf();
 
-    auto jsonObj = nlohmann::json::parse(jsonStr.str());
+    parseJson(nlohmann::json::parse(jsonStr.str()));
+}
+
+void Settings::parseJson(const nlohmann::json &jsonObj)
+{
     auto species = jsonObj.at("species");
     for (auto specie: species)
     {
@@ -70,11 +164,42 @@ void Settings::parseSettings(const std::string & configFileName)
 
         st.deathRate = specie.at("death_rate").get<double>();
         stateSettings.emplace(specie.at("state"), st);
+        stateNames.push_back(specie.at("state"));
     }
 
     seed = jsonObj.at("seed").get<uint>();
-    //birthRate = jsonObj.at("birth_rate").get<double>();
-    numOfEdges = jsonObj.at("initial_edges").get<size_t>();
+    simulationSeed = jsonObj.value("simulation_seed", uint64_t(0));
+    traceFile = jsonObj.value("trace", "");
+    lookAheadThreads = jsonObj.value("look_ahead_threads", size_t(1));
+    if (jsonObj.contains("look_ahead"))
+    {
+        parseLookAhead(jsonObj.at("look_ahead"));
+    }
+    tauLeapEpsilon = jsonObj.value("tau_leap_epsilon", 0.03);
+    if (!(tauLeapEpsilon > 0 && tauLeapEpsilon < 1))
+    {
+        std::string msg = "Invalid tau_leap_epsilon. It must be in (0, 1)";
+        throw std::domain_error(msg);
+    }
+    birthRate = jsonObj.value("birth_rate", 0.0);
+    birthState = jsonObj.value("birth_state", "");
+
+    if (jsonObj.contains("network"))
+    {
+        auto network = jsonObj.at("network");
+        networkSettings.edgeFile = network.at("edges").get<std::string>();
+        networkSettings.nodeFile = network.value("nodes", "");
+        std::string format = network.value("format", "text");
+        if (format != "text" && format != "binary")
+        {
+            std::string msg = "Invalid network format. Use \"text\" or \"binary\"";
+            throw std::domain_error(msg);
+        }
+        networkSettings.binary = (format == "binary");
+    }
+
+    //number of edges is given by the network file if one is provided
+    numOfEdges = hasNetworkFile() ? jsonObj.value("initial_edges", 0) : jsonObj.at("initial_edges").get<size_t>();
     simulationTime = jsonObj.at("simulation_time").get<double>();
 
     looseContactParameters.a = jsonObj.at("loose_contact_rate")[0].get<double>();
@@ -85,6 +210,210 @@ void Settings::parseSettings(const std::string & configFileName)
 
     transmissionRate = jsonObj.at("transmission_rate").get<double>();
     diagnosisRate = jsonObj.at("diagnosis_rate").get<double>();
+
+    if (jsonObj.contains("sweep"))
+    {
+        parseSweep(jsonObj.at("sweep"));
+    }
+
+    if (jsonObj.contains("model"))
+    {
+        parseModel(jsonObj.at("model"));
+    }
+
+    // rates of a configured model are given by its reactions, swept rates of the built-in model would be ignored
+    if (model && (!sweepSettings.transmissionRates.empty() || !sweepSettings.diagnosisRates.empty()))
+    {
+        std::string msg = "Invalid sweep. transmission_rate and diagnosis_rate can not be swept with a \"model\", "
+                          "they are rates of the built-in model only";
+        throw std::domain_error(msg);
+    }
+}
+
+void Settings::parseModel(const nlohmann::json& modelInfo)
+{
+    model = true;
+    for (const auto &transitionInfo: modelInfo.value("transitions", nlohmann::json::array()))
+    {
+        Transition transition;
+        transition.fromState = transitionInfo.at("from").get<std::string>();
+        transition.toState = transitionInfo.at("to").get<std::string>();
+        transition.rate = parseDistribution(transitionInfo.at("rate"));
+        transitions.push_back(transition);
+    }
+
+    for (const auto &interactionInfo: modelInfo.value("interactions", nlohmann::json::array()))
+    {
+        Interaction interaction;
+        interaction.fromStates = interactionInfo.at("from").get<std::vector<std::string>>();
+        interaction.toStates = interactionInfo.at("to").get<std::vector<std::string>>();
+        interaction.rate = parseDistribution(interactionInfo.at("rate"));
+        interactions.push_back(interaction);
+    }
+
+    for (const auto &adaptivityInfo: modelInfo.value("adaptivity", nlohmann::json::array()))
+    {
+        Adaptivity adapt;
+        adapt.state = adaptivityInfo.at("state").get<std::string>();
+        adapt.cutContacts = adaptivityInfo.value("cut_contacts", false);
+        adapt.newContactFactor = adaptivityInfo.value("new_contact_factor", 1.0);
+        adaptivity.push_back(adapt);
+    }
+}
+
+void Settings::parseSweep(const nlohmann::json& sweepInfo)
+{
+    sweep = true;
+    if (sweepInfo.contains("transmission_rate"))
+    {
+        sweepSettings.transmissionRates = parseSweepValues(sweepInfo.at("transmission_rate"));
+    }
+    if (sweepInfo.contains("diagnosis_rate"))
+    {
+        sweepSettings.diagnosisRates = parseSweepValues(sweepInfo.at("diagnosis_rate"));
+    }
+    for (const auto &range: sweepInfo.value("new_contact_rate", nlohmann::json::array()))
+    {
+        sweepSettings.newContactParameters.push_back({range[0].get<double>(), range[1].get<double>()});
+    }
+    for (const auto &range: sweepInfo.value("loose_contact_rate", nlohmann::json::array()))
+    {
+        sweepSettings.looseContactParameters.push_back({range[0].get<double>(), range[1].get<double>()});
+    }
+    sweepSettings.replicates = sweepInfo.value("replicates", 1);
+    sweepSettings.threads = sweepInfo.value("threads", 0);
+
+    if (sweepSettings.replicates == 0)
+    {
+        std::string msg = "Invalid sweep. Number of replicates must be positive";
+        throw std::domain_error(msg);
+    }
+}
+
+void Settings::parseLookAhead(const nlohmann::json& lookAheadInfo)
+{
+    lookAheadSettings.policy = lookAheadInfo.value("policy", "horizon");
+    if (lookAheadSettings.policy == "horizon")
+    {
+        lookAheadSettings.parameter = 0;
+    }
+    else if (lookAheadSettings.policy == "fixed")
+    {
+        lookAheadSettings.parameter = lookAheadInfo.at("window").get<double>();
+    }
+    else if (lookAheadSettings.policy == "mean_event_time")
+    {
+        lookAheadSettings.parameter = lookAheadInfo.value("factor", 10.0);
+    }
+    else if (lookAheadSettings.policy == "acceptance")
+    {
+        lookAheadSettings.parameter = lookAheadInfo.value("target", 0.5);
+        if (lookAheadSettings.parameter >= 1)
+        {
+            std::string msg = "Invalid look-ahead. Target acceptance ratio must be in (0, 1)";
+            throw std::domain_error(msg);
+        }
+    }
+    else
+    {
+        std::string msg = "Invalid look-ahead policy. Use \"horizon\", \"fixed\", \"mean_event_time\" or \"acceptance\"";
+        throw std::domain_error(msg);
+    }
+
+    if (lookAheadSettings.policy != "horizon" && !(lookAheadSettings.parameter > 0))
+    {
+        std::string msg = "Invalid look-ahead. Parameter of the policy must be positive";
+        throw std::domain_error(msg);
+    }
+}
+
+/*
+ * values are given either as list [v1, v2, ...] or as grid {"from": a, "to": b, "steps": n}
+ */
+std::vector<double> Settings::parseSweepValues(const nlohmann::json& values)
+{
+    std::vector<double> result;
+    if (values.is_array())
+    {
+        result = values.get<std::vector<double>>();
+    }
+    else if (values.is_object())
+    {
+        double from = values.at("from").get<double>();
+        double to = values.at("to").get<double>();
+        size_t steps = values.at("steps").get<size_t>();
+        if (steps < 2)
+        {
+            result.push_back(from);
+        }
+        else
+        {
+            for (size_t i = 0; i < steps; i++)
+            {
+                result.push_back(from + (to - from) * static_cast<double>(i) / static_cast<double>(steps - 1));
+            }
+        }
+    }
+    else
+    {
+        std::string msg = "Invalid sweep parameters. Provide list or grid";
+        throw std::domain_error(msg);
+    }
+    return result;
+}
+
+std::vector<Settings> Settings::expandSweep() const
+{
+    Settings base = *this;
+    base.sweep = false;
+    base.sweepSettings = SweepSettings();
+
+    auto orBase = []<typename T>(const std::vector<T> &values, const T &baseValue)
+    {
+        return values.empty() ? std::vector<T>{baseValue} : values;
+    };
+
+    std::vector<Settings> result;
+    // contact-rate ranges are the outer loops, so points sharing topology are adjacent
+    for (const auto &newContact: orBase(sweepSettings.newContactParameters, newContactParameters))
+    {
+        for (const auto &looseContact: orBase(sweepSettings.looseContactParameters, looseContactParameters))
+        {
+            for (double transmission: orBase(sweepSettings.transmissionRates, transmissionRate))
+            {
+                for (double diagnosis: orBase(sweepSettings.diagnosisRates, diagnosisRate))
+                {
+                    Settings point = base;
+                    point.newContactParameters = newContact;
+                    point.looseContactParameters = looseContact;
+                    point.transmissionRate = transmission;
+                    point.diagnosisRate = diagnosis;
+                    result.push_back(point);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool Settings::isSameTopology(const Settings &other) const
+{
+    bool sameStates = stateSettings.size() == other.stateSettings.size();
+    for (const auto &[state, specieSettings]: stateSettings)
+    {
+        auto it = other.stateSettings.find(state);
+        sameStates = sameStates && it != other.stateSettings.end() &&
+                     it->second.amount == specieSettings.amount;
+    }
+
+    return sameStates && seed == other.seed && numOfEdges == other.numOfEdges &&
+           networkSettings.edgeFile == other.networkSettings.edgeFile &&
+           networkSettings.nodeFile == other.networkSettings.nodeFile &&
+           networkSettings.binary == other.networkSettings.binary &&
+           newContactParameters.a == other.newContactParameters.a &&
+           newContactParameters.b == other.newContactParameters.b &&
+           looseContactParameters.a == other.looseContactParameters.a &&
+           looseContactParameters.b == other.looseContactParameters.b;
 }
 
 rateParameters Settings::parseDistribution(const nlohmann::json& distInfo)
@@ -7,6 +7,8 @@
 
 #include <vector>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include "nlohmann/json.h"
 
 struct rateParameters
@@ -28,6 +30,41 @@ struct distParameters
     double b;
 };
 
+/*
+ * files of the empirical network used as initial condition instead of random one.
+ * nodeFile is optional, if empty node states are taken from "species" and rates are sampled.
+ */
+struct NetworkSettings
+{
+    std::string edgeFile;
+    std::string nodeFile;
+    bool binary = false;
+};
+
+/*
+ * grid of a parameter sweep. Empty list means the parameter keeps the value of the base configuration.
+ * Points of the sweep are the cartesian product of all lists.
+ */
+struct SweepSettings
+{
+    std::vector<double> transmissionRates;
+    std::vector<double> diagnosisRates;
+    std::vector<distParameters> newContactParameters;
+    std::vector<distParameters> looseContactParameters;
+    size_t replicates = 1;
+    size_t threads = 0; // 0 - use all hardware threads
+};
+
+/*
+ * policy choosing the look-ahead window of SSATAN-X (@see LookAheadPolicy.h) and its parameter:
+ * window for "fixed", factor for "mean_event_time", target acceptance ratio for "acceptance", unused for "horizon"
+ */
+struct LookAheadSettings
+{
+    std::string policy = "horizon";
+    double parameter = 0;
+};
+
 struct SpecieSettings{
     size_t amount;
     double deathRate;
@@ -47,34 +84,95 @@ struct Interaction {
 
 };
 
+/*
+ * behaviour of a specie entering the state: cut all contacts and/or scale rate of establishing new contacts.
+ */
+struct Adaptivity {
+    std::string state;
+    bool cutContacts = false;
+    double newContactFactor = 1;
+};
+
 class Settings {
 public:
     double getSimulationTime() const;
     size_t getNumberOfEdges() const;
     std::unordered_map<std::string, SpecieSettings> getStateSettings() const;
+    std::vector<std::string> getStateNames() const; //@return names of the states in order of "species"
     double getDiagnosisRate() const;
     double getTransmissionRate() const;
-    //double getBirthRate() const;
+    double getBirthRate() const; //@return rate of births (immigration) into the population, 0 if not given
+    std::string getBirthState() const; //@return state of born species, empty - first state of the model
     uint getSeed() const;
+    bool hasSimulationSeed() const; //@return true if the seed of the simulation algorithm is fixed
+    uint64_t getSimulationSeed() const;
+    bool hasTrace() const; //@return true if a timeline of the run is recorded
+    std::string getTraceFile() const;
+    size_t getLookAheadThreads() const; //@return number of threads of the look-ahead bound of SSATAN-X, 0 - all
+    LookAheadSettings getLookAheadSettings() const;
+    double getTauLeapEpsilon() const; //@return allowed relative change of a channel per leap of -TAU
+    bool hasNetworkFile() const; //@return true if initial network is imported from file
+    NetworkSettings getNetworkSettings() const;
+    bool hasSweep() const; //@return true if config describes a parameter sweep
+    SweepSettings getSweepSettings() const;
+
+    bool hasModel() const; //@return true if config describes the model, otherwise built-in SID model is used
+    std::vector<Transition> getTransitions() const;
+    std::vector<Interaction> getInteractions() const;
+    std::vector<Adaptivity> getAdaptivity() const;
 
     distParameters getLooseConactRateParameters()const;
     distParameters getNewConactRateParameters()const;
 
     void parseSettings(const std::string & configFileName);
+    void parseJson(const nlohmann::json &jsonObj); //settings given as json object, e.g. generated by benchmarks
+
+    /*
+     * expands the sweep grid.
+     * @return settings of each point of the sweep, w/o sweep description
+     */
+    std::vector<Settings> expandSweep() const;
+
+    /*
+     * @return true if contact networks initialised with both settings are equal,
+     * i.e. all parameters but the epidemic ones (transmission & diagnosis rates) match
+     */
+    bool isSameTopology(const Settings &other) const;
+
+    void setSeed(uint s);
 
 private:
     double simulationTime;
     size_t numOfEdges;
     std::unordered_map<std::string, SpecieSettings> stateSettings;
+    std::vector<std::string> stateNames;
     double diagnosisRate;
     double transmissionRate;
-    //double birthRate;
+    double birthRate = 0;
+    std::string birthState;
     uint seed;
+    uint64_t simulationSeed = 0; // 0 - seed of the algorithm is chosen from time and pid
+    std::string traceFile;
+    size_t lookAheadThreads = 1;
+    LookAheadSettings lookAheadSettings;
+    double tauLeapEpsilon = 0.03;
+    NetworkSettings networkSettings;
+    SweepSettings sweepSettings;
+    bool sweep = false;
+
+    bool model = false;
+    std::vector<Transition> transitions;
+    std::vector<Interaction> interactions;
+    std::vector<Adaptivity> adaptivity;
 
     distParameters looseContactParameters;
     distParameters newContactParameters;
 
     rateParameters parseDistribution(const nlohmann::json& distInfo);
+    void parseSweep(const nlohmann::json& sweepInfo);
+    void parseModel(const nlohmann::json& modelInfo);
+    void parseLookAhead(const nlohmann::json& lookAheadInfo);
+    static std::vector<double> parseSweepValues(const nlohmann::json& values);
 };
 
 #endif //ALGO_SETTINGS_H
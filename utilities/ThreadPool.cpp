@@ -0,0 +1,101 @@
+//
+// Fixed-size pool of worker threads, see ThreadPool.h
+//
+
+#include <algorithm>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t nThreads)
+{
+    if (nThreads == 0)
+    {
+        nThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    workers.reserve(nThreads);
+    for (size_t i = 0; i < nThreads; i++)
+    {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    taskAvailable.notify_all();
+    for (auto &worker: workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this]() { return tasks.empty() && nRunning == 0; });
+
+    if (error)
+    {
+        std::exception_ptr toThrow = error;
+        error = nullptr;
+        std::rethrow_exception(toThrow);
+    }
+}
+
+size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stop || !tasks.empty(); });
+            if (stop && tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            nRunning++;
+        }
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            nRunning--;
+            if (tasks.empty() && nRunning == 0)
+            {
+                allDone.notify_all();
+            }
+        }
+    }
+}
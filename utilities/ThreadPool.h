@@ -0,0 +1,50 @@
+//
+// Fixed-size pool of worker threads executing submitted tasks in FIFO order.
+//
+
+#ifndef ALGO_THREADPOOL_H
+#define ALGO_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    /*
+     * @param nThreads number of worker threads, 0 - number of hardware threads
+     */
+    explicit ThreadPool(size_t nThreads = 0);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+
+    /*
+     * blocks until all submitted tasks are finished.
+     * If any task threw an exception, the first one is rethrown here.
+     */
+    void wait();
+
+    size_t size() const; //@return number of worker threads
+
+private:
+    void work();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    size_t nRunning = 0;
+    bool stop = false;
+    std::exception_ptr error;
+};
+
+#endif //ALGO_THREADPOOL_H
@@ -0,0 +1,68 @@
+//
+// Recorder of a timeline of the simulation, see TraceRecorder.h
+//
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include "TraceRecorder.h"
+
+thread_local TraceRecorder::Buffer *TraceRecorder::buffer = nullptr;
+
+TraceRecorder::TraceRecorder(const std::string &fileName) : fileName(fileName),
+                                                            origin(std::chrono::steady_clock::now())
+{
+}
+
+TraceRecorder::Scope::Scope(TraceRecorder *recorder, const std::string &label) : previous(buffer)
+{
+    if (recorder == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(recorder->mutex);
+    recorder->buffers.push_back(std::make_unique<Buffer>());
+    buffer = recorder->buffers.back().get();
+    buffer->label = label;
+    buffer->events.reserve(1 << 16);
+}
+
+TraceRecorder::Scope::~Scope()
+{
+    buffer = previous;
+}
+
+void TraceRecorder::flush()
+{
+    std::ofstream file(fileName);
+    if (!file)
+    {
+        std::string msg = "Can not write trace file " + fileName;
+        throw std::domain_error(msg);
+    }
+
+    auto microseconds = [&](std::chrono::steady_clock::time_point t)
+    {
+        return std::chrono::duration<double, std::micro>(t - origin).count();
+    };
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t tid = 0; tid < buffers.size(); tid++)
+    {
+        const Buffer &b = *buffers[tid];
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+             << ",\"args\":{\"name\":\"" << b.label << "\"}}";
+        first = false;
+        for (const Event &event: b.events)
+        {
+            file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                 << ",\"ts\":" << microseconds(event.start)
+                 << ",\"dur\":" << std::chrono::duration<double, std::micro>(event.end - event.start).count() << "}";
+        }
+    }
+    file << "\n]}" << std::endl;
+}
@@ -0,0 +1,124 @@
+/*
+ * Recorder of a timeline of the simulation in the Trace Event format (Chrome about:tracing, Perfetto UI).
+ *
+ * A recorder is activated for the calling thread by TraceRecorder::Scope; spans are then recorded by
+ * TraceRecorder::Span and by all Profiler::Timer of the thread (phases of the algorithms).
+ * Every scope writes into its own buffer which only its thread touches, so recording does not lock.
+ * Buffers are written to the file by flush() after the run. Every scope is shown as a separate track
+ * named by the label of the scope (e.g. replicates of a sweep).
+ *
+ * Tracing is compiled in together with profiling (SSATANX_PROFILING), otherwise spans are empty.
+*/
+
+#ifndef ALGO_TRACERECORDER_H
+#define ALGO_TRACERECORDER_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class TraceRecorder {
+private:
+
+    struct Event
+    {
+        const char *name;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    struct Buffer
+    {
+        std::string label;
+        std::vector<Event> events;
+    };
+
+public:
+
+    explicit TraceRecorder(const std::string &fileName);
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    /*
+     * writes all recorded events to the file. Must not be called while events are recorded.
+     */
+    void flush();
+
+    static bool isActive()
+    {
+        return buffer != nullptr;
+    }
+
+    /*
+     * records a complete event (span) for the active recorder of the thread, if any.
+     * @param name has to be a string literal or live until flush()
+     */
+    static void record(const char *name, std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end)
+    {
+        if (buffer != nullptr)
+        {
+            buffer->events.push_back({name, start, end});
+        }
+    }
+
+    /*
+     * activates the recorder for the calling thread until the end of the scope, no-op for nullptr
+     */
+    class Scope {
+    public:
+        Scope(TraceRecorder *recorder, const std::string &label);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Buffer *previous;
+    };
+
+    /*
+     * records a span from construction until the end of the scope
+     */
+    class Span {
+    public:
+        explicit Span([[maybe_unused]] const char *name)
+        {
+#ifdef SSATANX_PROFILING
+            if (isActive())
+            {
+                this->name = name;
+                start = std::chrono::steady_clock::now();
+            }
+#endif
+        }
+        ~Span()
+        {
+#ifdef SSATANX_PROFILING
+            if (this->name != nullptr)
+            {
+                record(name, start, std::chrono::steady_clock::now());
+            }
+#endif
+        }
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *name = nullptr;
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+
+    std::string fileName;
+    std::chrono::steady_clock::time_point origin;
+
+    std::mutex mutex; // guards only registration of buffers
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    static thread_local Buffer *buffer;
+};
+
+#endif //ALGO_TRACERECORDER_H
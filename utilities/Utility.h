@@ -7,7 +7,7 @@
 
 #include <random>
 
-auto lambdaLess = []<typename T>(const std::pair<double, T> &a,  double value) { return a.first < value; };
+inline auto lambdaLess = []<typename T>(const std::pair<double, T> &a,  double value) { return a.first < value; };
 
 double sampleRandUni(std::mt19937_64 &generator);
 #endif //ALGO_UTILITY_H
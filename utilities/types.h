@@ -6,8 +6,8 @@
 #define ALGO_TYPES_H
 
 #include <vector>
-#include <lemon/list_graph.h>
 #include "contact_network/Specie.h"
+#include "contact_network/ContactGraph.h"
 
 struct specieState
 {
@@ -16,7 +16,7 @@ struct specieState
     std::vector<int> contacts;
 };
 using NetworkStorage = std::vector<std::pair<double, std::vector<specieState>>>;
-using Edge = lemon::ListGraph::Edge;
-using Node = lemon::ListGraph::Node;
+using Edge = ContactGraph::Edge;
+using Node = ContactGraph::Node;
 
 #endif //ALGO_TYPES_H